@@ -0,0 +1,169 @@
+#include "CallTrace.hpp"
+
+#include <cstring>
+#include <system_error>
+
+#include "RowCache.hpp"
+
+namespace
+{
+	template<typename T>
+	auto Append(std::string& out, const T& value) -> void
+	{
+		out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	auto Consume(std::string_view& in, T& value) -> bool
+	{
+		if (in.size() < sizeof(T)) return false;
+		std::memcpy(&value, in.data(), sizeof(T));
+		in.remove_prefix(sizeof(T));
+		return true;
+	}
+
+	// Record size and timestamp, filled in by CallTraceWriter::Append
+	constexpr size_t RecordPrefixSize = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint64_t);
+}
+
+CallTraceRecord::CallTraceRecord(CallRecordKind kind)
+{
+	Append(m_buffer, uint32_t(0));
+	Append(m_buffer, static_cast<uint8_t>(kind));
+	Append(m_buffer, uint64_t(0));
+}
+
+auto CallTraceRecord::AddU8(uint8_t value) -> void
+{
+	Append(m_buffer, value);
+}
+
+auto CallTraceRecord::AddU32(uint32_t value) -> void
+{
+	Append(m_buffer, value);
+}
+
+auto CallTraceRecord::AddString(std::string_view value) -> void
+{
+	Append(m_buffer, static_cast<uint32_t>(value.size()));
+	m_buffer.append(value);
+}
+
+auto CallTraceRecord::AddValue(const FieldValue& value) -> void
+{
+	WriteFieldValue(m_buffer, value);
+}
+
+auto CallTraceWriter::Open(const std::filesystem::path& path, std::string& error) -> bool
+{
+	std::lock_guard lock(m_mutex);
+	if (m_file.is_open()) m_file.close();
+
+	std::error_code ec;
+	if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+
+	m_file.open(path, std::ios::binary | std::ios::trunc);
+	CallTraceHeader header;
+	std::memcpy(header.magic, CallTraceHeader::Magic, sizeof(header.magic));
+	header.version = CallTraceHeader::CurrentVersion;
+	m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (!m_file)
+	{
+		error = "Failed to write " + path.string();
+		m_file.close();
+		return false;
+	}
+
+	m_start = std::chrono::steady_clock::now();
+	return true;
+}
+
+auto CallTraceWriter::Close() -> void
+{
+	std::lock_guard lock(m_mutex);
+	if (m_file.is_open()) m_file.close();
+}
+
+auto CallTraceWriter::IsOpen() const -> bool
+{
+	std::lock_guard lock(m_mutex);
+	return m_file.is_open();
+}
+
+auto CallTraceWriter::Append(CallTraceRecord& record) -> void
+{
+	std::string& buffer = record.Buffer();
+	auto recordSize = static_cast<uint32_t>(buffer.size() - sizeof(uint32_t));
+	std::memcpy(buffer.data(), &recordSize, sizeof(recordSize));
+
+	std::lock_guard lock(m_mutex);
+	if (!m_file.is_open()) return;
+
+	// Taken under the lock, so timestamps never go backwards through the file
+	auto nanoseconds = static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+	std::memcpy(buffer.data() + sizeof(uint32_t) + sizeof(uint8_t), &nanoseconds, sizeof(nanoseconds));
+	m_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	// Once per frame, so a crash loses at most the calls of the frame it happened in
+	if (static_cast<CallRecordKind>(buffer[sizeof(uint32_t)]) == CallRecordKind::Update) m_file.flush();
+}
+
+auto CallRecordReader::ReadU8(uint8_t& value) -> bool
+{
+	return Consume(m_in, value);
+}
+
+auto CallRecordReader::ReadU32(uint32_t& value) -> bool
+{
+	return Consume(m_in, value);
+}
+
+auto CallRecordReader::ReadString(std::string_view& value) -> bool
+{
+	uint32_t size = 0;
+	if (!Consume(m_in, size) || m_in.size() < size) return false;
+	value = m_in.substr(0, size);
+	m_in.remove_prefix(size);
+	return true;
+}
+
+auto CallRecordReader::ReadValue(FieldValue& value) -> bool
+{
+	return ReadFieldValue(m_in, value);
+}
+
+CallTraceFile::CallTraceFile(const std::filesystem::path& path) : m_file(path)
+{
+	if (!m_file.IsOpen()) return;
+
+	std::string_view data = m_file.View();
+	CallTraceHeader header;
+	if (!Consume(data, header)) return;
+	if (std::memcmp(header.magic, CallTraceHeader::Magic, sizeof(header.magic)) != 0 ||
+		header.version != CallTraceHeader::CurrentVersion)
+	{
+		return;
+	}
+
+	while (data.size() >= RecordPrefixSize)
+	{
+		uint32_t recordSize = 0;
+		uint8_t kind = 0;
+		CallRecord record;
+		std::string_view prefix = data;
+		Consume(prefix, recordSize);
+		if (recordSize < RecordPrefixSize - sizeof(uint32_t) || prefix.size() < recordSize) break;
+
+		std::string_view body = prefix.substr(0, recordSize);
+		Consume(body, kind);
+		Consume(body, record.nanoseconds);
+		if (kind > static_cast<uint8_t>(CallRecordKind::Update)) break;
+
+		record.kind = static_cast<CallRecordKind>(kind);
+		record.payload = body;
+		m_records.push_back(record);
+		data = prefix.substr(recordSize);
+	}
+
+	m_valid = true;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FieldValue.hpp"
+#include "RowImport.hpp"
+
+// Capture of the calls that reach the workbench, so a user's exact mix of mods can be replayed
+// outside the game (see bench/ReplayTrace.cpp). Unlike the per-field trace mode, which times
+// the writes of one session, a call trace holds every input: the tables configured, the
+// settings, every row write with its full field tree, and the RowStruct layout of each table
+// as it resolved.
+//
+// Layout, little endian:
+//   CallTraceHeader
+//   per record: u32 record size (bytes after this field), u8 CallRecordKind,
+//               u64 nanoseconds since the capture started, then by kind:
+//     ConfigureTable  str name, str path
+//     Configure       value options, as ConfigureWorkbench takes them
+//     TableLayout     str name, value layout (see below)
+//     Writes          str table, u32 count, per write: u8 CallWriteMode, str row, str source row,
+//                     value fields
+//     Update          nothing, marks an on_update that applied the writes before it
+//   str:   u32 size + UTF-8 bytes
+//   value: FieldValue, encoded as in row cache files
+//
+// A layout is { row = struct, structs = { [struct] = { size = n, fields = { field, ... } } } }
+// keyed by struct path name, where a field is { name = s, kind = PropertyKind name, size = n }
+// plus struct = path for structs, inner = field for array elements and map keys, and value =
+// field for map values.
+
+struct CallTraceHeader
+{
+	static constexpr char Magic[8] = { 'T', 'F', 'W', 'C', 'A', 'L', 'L', 'S' };
+	static constexpr uint32_t CurrentVersion = 1;
+
+	char magic[8] = {};
+	uint32_t version = 0;
+	uint32_t reserved = 0;
+};
+
+enum class CallRecordKind : uint8_t
+{
+	ConfigureTable,
+	Configure,
+	TableLayout,
+	Writes,
+	Update,
+};
+
+// How a traced row was written, in the order of the mod's write modes
+enum class CallWriteMode : uint8_t
+{
+	Replace,
+	Patch,
+	Upsert,
+	Clone,
+};
+
+// One record being assembled, appended to the trace in one piece
+class CallTraceRecord
+{
+private:
+	std::string m_buffer = {};
+
+public:
+	explicit CallTraceRecord(CallRecordKind kind);
+
+	auto AddU8(uint8_t value) -> void;
+	auto AddU32(uint32_t value) -> void;
+	auto AddString(std::string_view value) -> void;
+	auto AddValue(const FieldValue& value) -> void;
+
+	auto Buffer() -> std::string& { return m_buffer; }
+};
+
+// Appends records to a trace file. Records may come from any thread.
+class CallTraceWriter
+{
+private:
+	mutable std::mutex m_mutex;
+	std::ofstream m_file = {};
+	std::chrono::steady_clock::time_point m_start = {};
+
+public:
+	// Replaces the file at `path` with an empty trace and captures into it
+	auto Open(const std::filesystem::path& path, std::string& error) -> bool;
+	auto Close() -> void;
+	auto IsOpen() const -> bool;
+
+	auto Append(CallTraceRecord& record) -> void;
+};
+
+// A record inside a mapped trace file
+struct CallRecord
+{
+	CallRecordKind kind = CallRecordKind::Update;
+	uint64_t nanoseconds = 0;
+	std::string_view payload;
+};
+
+// Reads the fields of a record payload in order. Every read returns false once the payload is
+// exhausted or malformed.
+class CallRecordReader
+{
+private:
+	std::string_view m_in;
+
+public:
+	explicit CallRecordReader(std::string_view payload) : m_in(payload) {}
+
+	auto ReadU8(uint8_t& value) -> bool;
+	auto ReadU32(uint32_t& value) -> bool;
+	auto ReadString(std::string_view& value) -> bool;
+	auto ReadValue(FieldValue& value) -> bool;
+
+	auto AtEnd() const -> bool { return m_in.empty(); }
+};
+
+// A trace file mapped for reading. Opening it checks the header and the framing of every
+// record.
+class CallTraceFile
+{
+private:
+	MappedFile m_file;
+	std::vector<CallRecord> m_records = {};
+	bool m_valid = false;
+
+public:
+	explicit CallTraceFile(const std::filesystem::path& path);
+
+	CallTraceFile(const CallTraceFile&) = delete;
+	auto operator=(const CallTraceFile&) -> CallTraceFile& = delete;
+
+	// False when the file is missing or damaged. A trace cut short by a crash keeps the records
+	// before the torn one.
+	auto IsValid() const -> bool { return m_valid; }
+	auto Records() const -> const std::vector<CallRecord>& { return m_records; }
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// A row value held in native memory, so a row write can be captured on whatever thread
+// produced it (a Lua state, a file import) and applied later on the game thread.
+// The accessors mirror LuaMadeSimple's LuaTableData.
+class FieldValue
+{
+public:
+	struct Entry;
+
+	enum class Type : uint8_t
+	{
+		Nil,
+		Bool,
+		Integer,
+		Number,
+		String,
+		Table,
+	};
+
+	// Deeper tables are cut off while marshalling. Tables that contain themselves are caught
+	// separately, see FieldValueFromLua.
+	static constexpr int MaxDepth = 32;
+
+private:
+	Type m_type = Type::Nil;
+	union
+	{
+		bool m_bool;
+		int64_t m_integer = 0;
+		double m_number;
+	};
+	std::string m_string = {};
+	std::vector<Entry> m_table = {};
+
+public:
+	static auto from_bool(bool value) -> FieldValue
+	{
+		FieldValue result;
+		result.m_type = Type::Bool;
+		result.m_bool = value;
+		return result;
+	}
+
+	static auto from_integer(int64_t value) -> FieldValue
+	{
+		FieldValue result;
+		result.m_type = Type::Integer;
+		result.m_integer = value;
+		return result;
+	}
+
+	static auto from_number(double value) -> FieldValue
+	{
+		FieldValue result;
+		result.m_type = Type::Number;
+		result.m_number = value;
+		return result;
+	}
+
+	static auto from_string(std::string_view value) -> FieldValue
+	{
+		FieldValue result;
+		result.m_type = Type::String;
+		result.m_string = value;
+		return result;
+	}
+
+	static auto make_table() -> FieldValue
+	{
+		FieldValue result;
+		result.m_type = Type::Table;
+		return result;
+	}
+
+	auto get_type() const -> Type { return m_type; }
+	auto is_nil() const -> bool { return m_type == Type::Nil; }
+	auto is_bool() const -> bool { return m_type == Type::Bool; }
+	auto is_integer() const -> bool { return m_type == Type::Integer; }
+	// True for integers as well, like lua_isnumber
+	auto is_number() const -> bool { return m_type == Type::Number || m_type == Type::Integer; }
+	auto is_string() const -> bool { return m_type == Type::String; }
+	auto is_table() const -> bool { return m_type == Type::Table; }
+
+	auto get_bool() const -> bool { return m_type == Type::Bool && m_bool; }
+	auto get_integer() const -> int64_t { return m_type == Type::Number ? static_cast<int64_t>(m_number) : m_type == Type::Integer ? m_integer : 0; }
+	auto get_number() const -> double { return m_type == Type::Integer ? static_cast<double>(m_integer) : m_type == Type::Number ? m_number : 0.0; }
+	auto get_string() const -> std::string_view { return m_string; }
+	auto get_table() const -> const std::vector<Entry>& { return m_table; }
+	auto get_table() -> std::vector<Entry>& { return m_table; }
+
+	// Conversions used by the scalar setters. Besides the matching type they accept strings
+	// that hold a complete literal, which is how CSV cells arrive.
+	auto to_integer(int64_t& value) const -> bool
+	{
+		if (m_type == Type::Integer)
+		{
+			value = m_integer;
+			return true;
+		}
+		if (m_type == Type::String)
+		{
+			auto [end, error] = std::from_chars(m_string.data(), m_string.data() + m_string.size(), value);
+			return error == std::errc() && end == m_string.data() + m_string.size();
+		}
+		return false;
+	}
+
+	auto to_number(double& value) const -> bool
+	{
+		if (is_number())
+		{
+			value = get_number();
+			return true;
+		}
+		if (m_type == Type::String)
+		{
+			auto [end, error] = std::from_chars(m_string.data(), m_string.data() + m_string.size(), value);
+			return error == std::errc() && end == m_string.data() + m_string.size();
+		}
+		return false;
+	}
+
+	auto to_bool(bool& value) const -> bool
+	{
+		if (m_type == Type::Bool)
+		{
+			value = m_bool;
+			return true;
+		}
+		if (m_type == Type::String && (m_string == "true" || m_string == "false"))
+		{
+			value = m_string == "true";
+			return true;
+		}
+		return false;
+	}
+
+	auto add(FieldValue key, FieldValue value) -> void;
+};
+
+struct FieldValue::Entry
+{
+	FieldValue key;
+	FieldValue value;
+};
+
+inline auto FieldValue::add(FieldValue key, FieldValue value) -> void
+{
+	m_table.push_back({ std::move(key), std::move(value) });
+}
@@ -0,0 +1,324 @@
+#include "RowCache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+auto HashBytes(const void* data, size_t size, uint64_t seed) -> uint64_t
+{
+	const auto* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+namespace
+{
+	// Word at a time, for hashes that are only compared in memory. HashBytes stays byte-wise as
+	// its hashes are stored in row cache files.
+	auto Mix(uint64_t hash, uint64_t word) -> uint64_t
+	{
+		hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+		return hash ^ (hash >> 29);
+	}
+
+	auto MixString(std::string_view value, uint64_t hash) -> uint64_t
+	{
+		hash = Mix(hash, value.size());
+		const char* data = value.data();
+		size_t size = value.size();
+		for (; size >= sizeof(uint64_t); data += sizeof(uint64_t), size -= sizeof(uint64_t))
+		{
+			uint64_t word;
+			std::memcpy(&word, data, sizeof(word));
+			hash = Mix(hash, word);
+		}
+
+		uint64_t tail = 0;
+		std::memcpy(&tail, data, size);
+		return Mix(hash, tail);
+	}
+}
+
+auto HashFieldValue(const FieldValue& value, uint64_t seed) -> uint64_t
+{
+	uint64_t hash = Mix(seed, static_cast<uint64_t>(value.get_type()));
+	switch (value.get_type())
+	{
+	case FieldValue::Type::Bool:
+		return Mix(hash, value.get_bool());
+	case FieldValue::Type::Integer:
+		return Mix(hash, static_cast<uint64_t>(value.get_integer()));
+	case FieldValue::Type::Number:
+		return Mix(hash, std::bit_cast<uint64_t>(value.get_number()));
+	case FieldValue::Type::String:
+		return MixString(value.get_string(), hash);
+	case FieldValue::Type::Table:
+	{
+		uint64_t sum = 0;
+		for (const FieldValue::Entry& entry : value.get_table())
+		{
+			sum += HashFieldValue(entry.value, HashFieldValue(entry.key));
+		}
+		return Mix(Mix(hash, value.get_table().size()), sum);
+	}
+	default:
+		return hash;
+	}
+}
+
+namespace
+{
+	template<typename T>
+	auto Append(std::string& out, const T& value) -> void
+	{
+		out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	auto Consume(std::string_view& in, T& value) -> bool
+	{
+		if (in.size() < sizeof(T)) return false;
+		std::memcpy(&value, in.data(), sizeof(T));
+		in.remove_prefix(sizeof(T));
+		return true;
+	}
+}
+
+auto WriteFieldValue(std::string& out, const FieldValue& value) -> void
+{
+	Append(out, static_cast<uint8_t>(value.get_type()));
+	switch (value.get_type())
+	{
+	case FieldValue::Type::Nil:
+		break;
+	case FieldValue::Type::Bool:
+		Append(out, static_cast<uint8_t>(value.get_bool()));
+		break;
+	case FieldValue::Type::Integer:
+		Append(out, static_cast<int64_t>(value.get_integer()));
+		break;
+	case FieldValue::Type::Number:
+		Append(out, value.get_number());
+		break;
+	case FieldValue::Type::String:
+		Append(out, static_cast<uint32_t>(value.get_string().size()));
+		out.append(value.get_string());
+		break;
+	case FieldValue::Type::Table:
+		Append(out, static_cast<uint32_t>(value.get_table().size()));
+		for (const FieldValue::Entry& entry : value.get_table())
+		{
+			WriteFieldValue(out, entry.key);
+			WriteFieldValue(out, entry.value);
+		}
+		break;
+	}
+}
+
+auto ReadFieldValue(std::string_view& in, FieldValue& value, int depth) -> bool
+{
+	if (depth > FieldValue::MaxDepth) return false;
+
+	uint8_t type = 0;
+	if (!Consume(in, type)) return false;
+
+	switch (static_cast<FieldValue::Type>(type))
+	{
+	case FieldValue::Type::Nil:
+		value = FieldValue();
+		return true;
+	case FieldValue::Type::Bool:
+	{
+		uint8_t boolean = 0;
+		if (!Consume(in, boolean)) return false;
+		value = FieldValue::from_bool(boolean != 0);
+		return true;
+	}
+	case FieldValue::Type::Integer:
+	{
+		int64_t integer = 0;
+		if (!Consume(in, integer)) return false;
+		value = FieldValue::from_integer(integer);
+		return true;
+	}
+	case FieldValue::Type::Number:
+	{
+		double number = 0.0;
+		if (!Consume(in, number)) return false;
+		value = FieldValue::from_number(number);
+		return true;
+	}
+	case FieldValue::Type::String:
+	{
+		uint32_t size = 0;
+		if (!Consume(in, size) || in.size() < size) return false;
+		value = FieldValue::from_string(in.substr(0, size));
+		in.remove_prefix(size);
+		return true;
+	}
+	case FieldValue::Type::Table:
+	{
+		uint32_t count = 0;
+		if (!Consume(in, count)) return false;
+		value = FieldValue::make_table();
+		// Every entry takes at least two bytes, which bounds the reservation on bad data
+		value.get_table().reserve(std::min<size_t>(count, in.size() / 2));
+		for (uint32_t i = 0; i < count; i++)
+		{
+			FieldValue key, entryValue;
+			if (!ReadFieldValue(in, key, depth + 1) || !ReadFieldValue(in, entryValue, depth + 1)) return false;
+			value.add(std::move(key), std::move(entryValue));
+		}
+		return true;
+	}
+	}
+	return false;
+}
+
+RowCacheWriter::RowCacheWriter(uint64_t inputHash, uint64_t layoutHash, uint32_t structSize)
+{
+	std::memcpy(m_header.magic, RowCacheHeader::Magic, sizeof(m_header.magic));
+	m_header.version = RowCacheHeader::CurrentVersion;
+	m_header.structSize = structSize;
+	m_header.inputHash = inputHash;
+	m_header.layoutHash = layoutHash;
+
+	// Placeholder, the final header is written over it by Save
+	Append(m_buffer, m_header);
+}
+
+auto RowCacheWriter::BeginRow(std::string_view rowName, const void* image) -> void
+{
+	m_row_start = m_buffer.size();
+	Append(m_buffer, uint32_t(0));
+	Append(m_buffer, static_cast<uint32_t>(rowName.size()));
+	m_buffer.append(rowName);
+	m_buffer.append(static_cast<const char*>(image), m_header.structSize);
+	m_field_count_offset = m_buffer.size();
+	m_field_count = 0;
+	Append(m_buffer, m_field_count);
+}
+
+auto RowCacheWriter::AddField(const FieldValue& key, const FieldValue& value, bool fixup) -> void
+{
+	Append(m_buffer, static_cast<uint8_t>(fixup));
+	WriteFieldValue(m_buffer, key);
+	WriteFieldValue(m_buffer, value);
+	m_field_count++;
+}
+
+auto RowCacheWriter::EndRow() -> void
+{
+	auto recordSize = static_cast<uint32_t>(m_buffer.size() - m_row_start - sizeof(uint32_t));
+	std::memcpy(m_buffer.data() + m_row_start, &recordSize, sizeof(recordSize));
+	std::memcpy(m_buffer.data() + m_field_count_offset, &m_field_count, sizeof(m_field_count));
+	m_header.rowCount++;
+}
+
+auto RowCacheWriter::Save(const std::filesystem::path& path, std::string& error) -> bool
+{
+	std::memcpy(m_buffer.data(), &m_header, sizeof(m_header));
+
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+
+	std::filesystem::path temporary = path;
+	temporary += ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+		if (!file)
+		{
+			error = "Failed to write " + temporary.string();
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporary, path, ec);
+	if (ec)
+	{
+		error = "Failed to replace " + path.string() + ": " + ec.message();
+		std::filesystem::remove(temporary, ec);
+		return false;
+	}
+	return true;
+}
+
+RowCacheFile::RowCacheFile(const std::filesystem::path& path, uint64_t inputHash) : m_file(path)
+{
+	if (!m_file.IsOpen()) return;
+
+	std::string_view data = m_file.View();
+	if (!Consume(data, m_header)) return;
+	if (std::memcmp(m_header.magic, RowCacheHeader::Magic, sizeof(m_header.magic)) != 0 ||
+		m_header.version != RowCacheHeader::CurrentVersion ||
+		m_header.inputHash != inputHash)
+	{
+		return;
+	}
+
+	m_rows.reserve(m_header.rowCount);
+	for (uint32_t i = 0; i < m_header.rowCount; i++)
+	{
+		const char* record = data.data();
+		uint32_t recordSize = 0;
+		uint32_t nameSize = 0;
+		if (!Consume(data, recordSize) || data.size() < recordSize) return;
+
+		std::string_view body = data.substr(0, recordSize);
+		if (!Consume(body, nameSize) ||
+			body.size() < static_cast<uint64_t>(nameSize) + m_header.structSize + sizeof(uint32_t))
+		{
+			return;
+		}
+
+		m_rows.push_back(record);
+		data.remove_prefix(recordSize);
+	}
+
+	m_valid = data.empty();
+}
+
+auto RowCacheFile::ReadRow(const char* record) const -> CachedRow
+{
+	uint32_t recordSize = 0;
+	uint32_t nameSize = 0;
+	std::string_view body(record, sizeof(uint32_t));
+	Consume(body, recordSize);
+	body = std::string_view(record + sizeof(uint32_t), recordSize);
+	Consume(body, nameSize);
+
+	CachedRow row;
+	row.name = body.substr(0, nameSize);
+	body.remove_prefix(nameSize);
+	row.image = reinterpret_cast<const uint8_t*>(body.data());
+	body.remove_prefix(m_header.structSize);
+	Consume(body, row.fieldCount);
+	row.fields = body;
+	return row;
+}
+
+auto ReadCachedFields(const CachedRow& row, bool fixupsOnly, FieldValue& fields) -> bool
+{
+	std::string_view in = row.fields;
+	fields = FieldValue::make_table();
+	for (uint32_t i = 0; i < row.fieldCount; i++)
+	{
+		uint8_t fixup = 0;
+		FieldValue key, value;
+		if (!Consume(in, fixup) || !ReadFieldValue(in, key, 1) || !ReadFieldValue(in, value, 1)) return false;
+
+		if (fixup || !fixupsOnly)
+		{
+			fields.add(std::move(key), std::move(value));
+		}
+	}
+	return true;
+}
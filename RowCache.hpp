@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FieldValue.hpp"
+#include "RowImport.hpp"
+
+// On-disk cache of the rows an import produced, so an unchanged import file skips parsing and
+// most of the field writes on the next launch.
+//
+// A cache file belongs to one (table, import file) pair and stores, for every row, the finished
+// row image and the fields of the row input. Fields that are plain bytes in the row (numbers,
+// bools, enums and structs made only of those) are copied straight from the image. Everything
+// that points at memory owned by this process (names, strings, text, objects, containers) is
+// marked as a fixup and written again from its input value. The non-fixup inputs are kept so a
+// row can still be rebuilt when the RowStruct layout no longer matches the image.
+//
+// Layout, little endian:
+//   RowCacheHeader
+//   per row: u32 record size (bytes after this field), u32 name size, name,
+//            image[structSize], u32 field count, per field: u8 fixup, key, value
+//   values:  u8 FieldValue::Type, then u8 bool | i64 integer | f64 number |
+//            u32 size + bytes for strings | u32 count + key/value pairs for tables
+
+struct RowCacheHeader
+{
+	static constexpr char Magic[8] = { 'T', 'F', 'W', 'R', 'O', 'W', 'S', '\0' };
+	static constexpr uint32_t CurrentVersion = 1;
+
+	char magic[8] = {};
+	uint32_t version = 0;
+	uint32_t structSize = 0;
+	// Hash of the import file's bytes
+	uint64_t inputHash = 0;
+	// Hash of the RowStruct layout the images were taken with, see StructWritePlan::layoutHash
+	uint64_t layoutHash = 0;
+	uint32_t rowCount = 0;
+	uint32_t reserved = 0;
+};
+
+// 64-bit FNV-1a, used for input and layout hashes. `seed` chains several inputs together.
+constexpr uint64_t HashSeed = 0xcbf29ce484222325ull;
+auto HashBytes(const void* data, size_t size, uint64_t seed = HashSeed) -> uint64_t;
+
+template<typename T>
+auto HashValue(const T& value, uint64_t seed) -> uint64_t
+{
+	return HashBytes(&value, sizeof(T), seed);
+}
+
+// Hash of a value's content. Table entries are combined independently of their order, so a Lua
+// table hashes the same however its pairs were iterated when it was marshalled.
+auto HashFieldValue(const FieldValue& value, uint64_t seed = HashSeed) -> uint64_t;
+
+// The value encoding of row cache files, shared with call traces (see CallTrace.hpp).
+// ReadFieldValue returns false on malformed data or tables nested deeper than MaxDepth.
+auto WriteFieldValue(std::string& out, const FieldValue& value) -> void;
+auto ReadFieldValue(std::string_view& in, FieldValue& value, int depth = 0) -> bool;
+
+// Appends rows to an in-memory cache image and writes it out in one go
+class RowCacheWriter
+{
+private:
+	std::string m_buffer = {};
+	RowCacheHeader m_header = {};
+	size_t m_row_start = 0;
+	size_t m_field_count_offset = 0;
+	uint32_t m_field_count = 0;
+
+public:
+	RowCacheWriter(uint64_t inputHash, uint64_t layoutHash, uint32_t structSize);
+
+	auto BeginRow(std::string_view rowName, const void* image) -> void;
+	auto AddField(const FieldValue& key, const FieldValue& value, bool fixup) -> void;
+	auto EndRow() -> void;
+
+	auto RowCount() const -> uint32_t { return m_header.rowCount; }
+
+	// Writes to a temporary file first so a crash never leaves a torn cache behind
+	auto Save(const std::filesystem::path& path, std::string& error) -> bool;
+};
+
+// One row record inside a mapped cache file
+struct CachedRow
+{
+	std::string_view name;
+	const uint8_t* image = nullptr;
+	uint32_t fieldCount = 0;
+	// Encoded fields, read with ReadCachedFields
+	std::string_view fields;
+};
+
+// A cache file mapped for reading. Opening it checks the header and the bounds of every record,
+// so rows handed out afterwards can be decoded without further checks on the framing.
+class RowCacheFile
+{
+private:
+	MappedFile m_file;
+	RowCacheHeader m_header = {};
+	std::vector<const char*> m_rows = {};
+	bool m_valid = false;
+
+public:
+	RowCacheFile(const std::filesystem::path& path, uint64_t inputHash);
+
+	RowCacheFile(const RowCacheFile&) = delete;
+	auto operator=(const RowCacheFile&) -> RowCacheFile& = delete;
+
+	// False when the file is missing, damaged or was written for different input
+	auto IsValid() const -> bool { return m_valid; }
+	auto Header() const -> const RowCacheHeader& { return m_header; }
+	auto Rows() const -> const std::vector<const char*>& { return m_rows; }
+
+	auto ReadRow(const char* record) const -> CachedRow;
+};
+
+// Decodes the fields of `row` into the table `fields`. With `fixupsOnly` the fields copied from
+// the image are skipped. Returns false on malformed data.
+auto ReadCachedFields(const CachedRow& row, bool fixupsOnly, FieldValue& fields) -> bool;
@@ -0,0 +1,615 @@
+#include "RowImport.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return;
+	m_file = file;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file, &size)) return;
+	m_size = static_cast<size_t>(size.QuadPart);
+
+	// Empty files can't be mapped, but they are valid (and empty) documents
+	if (m_size > 0)
+	{
+		m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mapping) return;
+
+		m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!m_data) return;
+	}
+#else
+	m_fd = open(path.c_str(), O_RDONLY);
+	if (m_fd < 0) return;
+
+	struct stat info{};
+	if (fstat(m_fd, &info) != 0) return;
+	m_size = static_cast<size_t>(info.st_size);
+
+	if (m_size > 0)
+	{
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+		if (data == MAP_FAILED) return;
+		m_data = static_cast<const char*>(data);
+		madvise(data, m_size, MADV_SEQUENTIAL);
+	}
+#endif
+	m_open = true;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (m_data) UnmapViewOfFile(m_data);
+	if (m_mapping) CloseHandle(m_mapping);
+	if (m_file) CloseHandle(m_file);
+#else
+	if (m_data) munmap(const_cast<char*>(m_data), m_size);
+	if (m_fd >= 0) close(m_fd);
+#endif
+}
+
+namespace
+{
+	// Recursive descent JSON parser working directly on the mapped bytes
+	class JsonParser
+	{
+	private:
+		const char* m_pos;
+		const char* m_end;
+		const char* m_begin;
+		std::string& m_error;
+
+	public:
+		JsonParser(std::string_view document, std::string& error)
+			: m_pos(document.data()), m_end(document.data() + document.size()), m_begin(document.data()), m_error(error)
+		{
+			// UTF-8 byte order mark
+			if (document.starts_with("\xEF\xBB\xBF")) m_pos += 3;
+		}
+
+		auto Fail(std::string_view message) -> bool
+		{
+			if (m_error.empty())
+			{
+				m_error = std::string(message) + " at offset " + std::to_string(m_pos - m_begin);
+			}
+			return false;
+		}
+
+		auto SkipWhitespace() -> void
+		{
+			while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) m_pos++;
+		}
+
+		auto AtEnd() -> bool
+		{
+			SkipWhitespace();
+			return m_pos >= m_end;
+		}
+
+		// Consumes `c` if it is the next non-whitespace character
+		auto Consume(char c) -> bool
+		{
+			SkipWhitespace();
+			if (m_pos < m_end && *m_pos == c)
+			{
+				m_pos++;
+				return true;
+			}
+			return false;
+		}
+
+		auto Expect(char c) -> bool
+		{
+			if (Consume(c)) return true;
+			return Fail(std::string("Expected '") + c + "'");
+		}
+
+		auto Peek() -> char
+		{
+			SkipWhitespace();
+			return m_pos < m_end ? *m_pos : '\0';
+		}
+
+		static auto AppendUtf8(std::string& out, uint32_t codePoint) -> void
+		{
+			if (codePoint < 0x80)
+			{
+				out.push_back(static_cast<char>(codePoint));
+			}
+			else if (codePoint < 0x800)
+			{
+				out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+				out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			else if (codePoint < 0x10000)
+			{
+				out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+				out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			else
+			{
+				out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+				out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+		}
+
+		auto ParseHex4(uint32_t& value) -> bool
+		{
+			if (m_end - m_pos < 4) return Fail("Truncated \\u escape");
+			auto [end, error] = std::from_chars(m_pos, m_pos + 4, value, 16);
+			if (error != std::errc() || end != m_pos + 4) return Fail("Invalid \\u escape");
+			m_pos += 4;
+			return true;
+		}
+
+		auto ParseString(std::string& out) -> bool
+		{
+			if (!Expect('"')) return false;
+
+			out.clear();
+			while (m_pos < m_end)
+			{
+				// Copy the run up to the next quote or escape in one go
+				const char* runStart = m_pos;
+				while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\') m_pos++;
+				out.append(runStart, m_pos);
+				if (m_pos >= m_end) break;
+
+				if (*m_pos++ == '"') return true;
+
+				if (m_pos >= m_end) break;
+				char escape = *m_pos++;
+				switch (escape)
+				{
+				case '"': out.push_back('"'); break;
+				case '\\': out.push_back('\\'); break;
+				case '/': out.push_back('/'); break;
+				case 'b': out.push_back('\b'); break;
+				case 'f': out.push_back('\f'); break;
+				case 'n': out.push_back('\n'); break;
+				case 'r': out.push_back('\r'); break;
+				case 't': out.push_back('\t'); break;
+				case 'u':
+				{
+					uint32_t codePoint = 0;
+					if (!ParseHex4(codePoint)) return false;
+					// Surrogates only come in pairs, a high one followed by a low one
+					if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) return Fail("Invalid surrogate pair");
+					if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+					{
+						if (m_end - m_pos < 6 || m_pos[0] != '\\' || m_pos[1] != 'u') return Fail("Invalid surrogate pair");
+						m_pos += 2;
+						uint32_t low = 0;
+						if (!ParseHex4(low)) return false;
+						if (low < 0xDC00 || low > 0xDFFF) return Fail("Invalid surrogate pair");
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+					AppendUtf8(out, codePoint);
+					break;
+				}
+				default:
+					return Fail("Invalid escape sequence");
+				}
+			}
+			return Fail("Unterminated string");
+		}
+
+		auto ParseNumber(FieldValue& out) -> bool
+		{
+			const char* start = m_pos;
+			bool isInteger = true;
+			while (m_pos < m_end)
+			{
+				char c = *m_pos;
+				if (c == '.' || c == 'e' || c == 'E') isInteger = false;
+				else if (!(std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '+')) break;
+				m_pos++;
+			}
+
+			if (isInteger)
+			{
+				int64_t value = 0;
+				auto [end, error] = std::from_chars(start, m_pos, value);
+				if (error == std::errc() && end == m_pos)
+				{
+					out = FieldValue::from_integer(value);
+					return true;
+				}
+			}
+
+			double value = 0.0;
+			auto [end, error] = std::from_chars(start, m_pos, value);
+			if (error != std::errc() || end != m_pos)
+			{
+				m_pos = start;
+				return Fail("Invalid number");
+			}
+			out = FieldValue::from_number(value);
+			return true;
+		}
+
+		auto ParseLiteral(std::string_view literal) -> bool
+		{
+			if (static_cast<size_t>(m_end - m_pos) < literal.size() || std::string_view(m_pos, literal.size()) != literal)
+			{
+				return Fail("Invalid literal");
+			}
+			m_pos += literal.size();
+			return true;
+		}
+
+		auto ParseValue(FieldValue& out, int depth) -> bool
+		{
+			if (depth > FieldValue::MaxDepth) return Fail("Document nested too deeply");
+
+			switch (Peek())
+			{
+			case '{':
+			{
+				m_pos++;
+				out = FieldValue::make_table();
+				if (Consume('}')) return true;
+
+				std::string key;
+				do
+				{
+					FieldValue value;
+					if (!ParseString(key) || !Expect(':') || !ParseValue(value, depth + 1)) return false;
+					out.add(FieldValue::from_string(key), std::move(value));
+				} while (Consume(','));
+				return Expect('}');
+			}
+			case '[':
+			{
+				m_pos++;
+				out = FieldValue::make_table();
+				if (Consume(']')) return true;
+
+				int64_t index = 1;
+				do
+				{
+					FieldValue value;
+					if (!ParseValue(value, depth + 1)) return false;
+					out.add(FieldValue::from_integer(index++), std::move(value));
+				} while (Consume(','));
+				return Expect(']');
+			}
+			case '"':
+			{
+				std::string value;
+				if (!ParseString(value)) return false;
+				out = FieldValue::from_string(value);
+				return true;
+			}
+			case 't':
+				out = FieldValue::from_bool(true);
+				return ParseLiteral("true");
+			case 'f':
+				out = FieldValue::from_bool(false);
+				return ParseLiteral("false");
+			case 'n':
+				out = {};
+				return ParseLiteral("null");
+			default:
+				return ParseNumber(out);
+			}
+		}
+
+		// Streams the top level container, handing each row over before parsing the next one
+		auto ParseRows(const RowCallback& onRow) -> bool
+		{
+			if (Consume('{'))
+			{
+				if (Consume('}')) return AtEnd() || Fail("Trailing data");
+
+				std::string rowName;
+				do
+				{
+					FieldValue fields;
+					if (!ParseString(rowName) || !Expect(':') || !ParseValue(fields, 1)) return false;
+					if (!fields.is_table()) return Fail("Expected an object of fields for row '" + rowName + "'");
+					onRow(rowName, fields);
+				} while (Consume(','));
+				if (!Expect('}')) return false;
+			}
+			else if (Consume('['))
+			{
+				if (Consume(']')) return AtEnd() || Fail("Trailing data");
+
+				do
+				{
+					FieldValue fields;
+					if (!ParseValue(fields, 1)) return false;
+					if (!fields.is_table()) return Fail("Expected an object per row");
+
+					// The row name travels as the "Name" field, which isn't a property of the row
+					std::string rowName;
+					auto& entries = fields.get_table();
+					for (auto it = entries.begin(); it != entries.end(); ++it)
+					{
+						if (it->key.is_string() && it->key.get_string() == "Name" && it->value.is_string())
+						{
+							rowName = it->value.get_string();
+							entries.erase(it);
+							break;
+						}
+					}
+					if (rowName.empty()) return Fail("Row without a \"Name\" field");
+					onRow(rowName, fields);
+				} while (Consume(','));
+				if (!Expect(']')) return false;
+			}
+			else
+			{
+				return Fail("Expected '{' or '[' at the top level");
+			}
+
+			return AtEnd() || Fail("Trailing data");
+		}
+	};
+
+	// RFC 4180 records: comma separated, optionally quoted with "" as the escaped quote
+	class CsvParser
+	{
+	private:
+		const char* m_pos;
+		const char* m_end;
+
+	public:
+		explicit CsvParser(std::string_view document)
+			: m_pos(document.data()), m_end(document.data() + document.size())
+		{
+			if (document.starts_with("\xEF\xBB\xBF")) m_pos += 3;
+		}
+
+		auto AtEnd() const -> bool { return m_pos >= m_end; }
+
+		// Reads the next record into `cells`, reusing their storage. Returns false on an unterminated quote.
+		auto ReadRecord(std::vector<std::string>& cells, size_t& count) -> bool
+		{
+			count = 0;
+			while (true)
+			{
+				if (cells.size() <= count) cells.emplace_back();
+				std::string& cell = cells[count++];
+				cell.clear();
+
+				if (m_pos < m_end && *m_pos == '"')
+				{
+					m_pos++;
+					while (true)
+					{
+						if (m_pos >= m_end) return false;
+						if (*m_pos == '"')
+						{
+							if (m_pos + 1 < m_end && m_pos[1] == '"')
+							{
+								cell.push_back('"');
+								m_pos += 2;
+								continue;
+							}
+							m_pos++;
+							break;
+						}
+						cell.push_back(*m_pos++);
+					}
+				}
+
+				const char* runStart = m_pos;
+				while (m_pos < m_end && *m_pos != ',' && *m_pos != '\n' && *m_pos != '\r') m_pos++;
+				cell.append(runStart, m_pos);
+
+				if (m_pos < m_end && *m_pos == ',')
+				{
+					m_pos++;
+					continue;
+				}
+
+				if (m_pos < m_end && *m_pos == '\r') m_pos++;
+				if (m_pos < m_end && *m_pos == '\n') m_pos++;
+				return true;
+			}
+		}
+	};
+}
+
+auto ReadJsonRows(std::string_view document, const RowCallback& onRow, std::string& error) -> bool
+{
+	JsonParser parser(document, error);
+	return parser.ParseRows(onRow);
+}
+
+auto ReadCsvRows(std::string_view document, const RowCallback& onRow, std::string& error) -> bool
+{
+	CsvParser parser(document);
+
+	std::vector<std::string> header;
+	size_t columns = 0;
+	if (!parser.ReadRecord(header, columns))
+	{
+		error = "Unterminated quote in header";
+		return false;
+	}
+
+	std::vector<std::string> cells;
+	size_t count = 0;
+	size_t line = 1;
+	while (!parser.AtEnd())
+	{
+		line++;
+		if (!parser.ReadRecord(cells, count))
+		{
+			error = "Unterminated quote in record " + std::to_string(line);
+			return false;
+		}
+		if (count == 1 && cells[0].empty()) continue;
+
+		FieldValue fields = FieldValue::make_table();
+		for (size_t i = 1; i < count && i < columns; i++)
+		{
+			const std::string& cell = cells[i];
+			if (cell.empty()) continue;
+
+			if (cell.front() == '{' || cell.front() == '[')
+			{
+				FieldValue value;
+				std::string cellError;
+				JsonParser cellParser(cell, cellError);
+				// The value has to take up the whole cell
+				if (!cellParser.ParseValue(value, 1) || !(cellParser.AtEnd() || cellParser.Fail("Trailing data")))
+				{
+					error = "Record " + std::to_string(line) + ", column '" + header[i] + "': " + cellError;
+					return false;
+				}
+				fields.add(FieldValue::from_string(header[i]), std::move(value));
+			}
+			else
+			{
+				fields.add(FieldValue::from_string(header[i]), FieldValue::from_string(cell));
+			}
+		}
+
+		onRow(cells[0], fields);
+	}
+	return true;
+}
+
+auto ReadRowDocument(const std::filesystem::path& path, std::string_view document, const RowCallback& onRow, std::string& error) -> bool
+{
+	std::string extension = path.extension().string();
+	for (char& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+	if (extension == ".json")
+	{
+		return ReadJsonRows(document, onRow, error);
+	}
+	if (extension == ".csv")
+	{
+		return ReadCsvRows(document, onRow, error);
+	}
+
+	error = "Unsupported file type '" + extension + "', expected .json or .csv";
+	return false;
+}
+
+namespace
+{
+	auto AppendJsonString(std::string_view value, std::string& out) -> void
+	{
+		out.push_back('"');
+		for (char c : value)
+		{
+			switch (c)
+			{
+			case '"': out.append("\\\""); break;
+			case '\\': out.append("\\\\"); break;
+			case '\n': out.append("\\n"); break;
+			case '\r': out.append("\\r"); break;
+			case '\t': out.append("\\t"); break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					constexpr char hex[] = "0123456789abcdef";
+					out.append("\\u00").push_back(hex[c >> 4]);
+					out.push_back(hex[c & 0xf]);
+				}
+				else
+				{
+					out.push_back(c);
+				}
+			}
+		}
+		out.push_back('"');
+	}
+
+	auto AppendJsonValue(const FieldValue& value, std::string& out, int indent) -> void
+	{
+		switch (value.get_type())
+		{
+		case FieldValue::Type::Bool:
+			out.append(value.get_bool() ? "true" : "false");
+			return;
+		case FieldValue::Type::Integer:
+		case FieldValue::Type::Number:
+		{
+			// JSON has no infinities or NaN
+			if (!value.is_integer() && !std::isfinite(value.get_number()))
+			{
+				out.append("null");
+				return;
+			}
+			char buffer[32];
+			auto [end, error] = value.is_integer()
+				? std::to_chars(buffer, buffer + sizeof(buffer), value.get_integer())
+				: std::to_chars(buffer, buffer + sizeof(buffer), value.get_number());
+			out.append(buffer, end);
+			return;
+		}
+		case FieldValue::Type::String:
+			AppendJsonString(value.get_string(), out);
+			return;
+		case FieldValue::Type::Table:
+			break;
+		default:
+			out.append("null");
+			return;
+		}
+
+		// A table with any string key becomes an object, keyed by the string keys only
+		const auto& entries = value.get_table();
+		bool object = std::any_of(entries.begin(), entries.end(), [](const FieldValue::Entry& entry) { return entry.key.is_string(); });
+		if (entries.empty())
+		{
+			out.append(object ? "{}" : "[]");
+			return;
+		}
+
+		out.push_back(object ? '{' : '[');
+		bool first = true;
+		for (const FieldValue::Entry& entry : entries)
+		{
+			if (object && !entry.key.is_string()) continue;
+
+			out.append(first ? "\n" : ",\n").append(static_cast<size_t>(indent + 1) * 2, ' ');
+			first = false;
+			if (object)
+			{
+				AppendJsonString(entry.key.get_string(), out);
+				out.append(": ");
+			}
+			AppendJsonValue(entry.value, out, indent + 1);
+		}
+		out.push_back('\n');
+		out.append(static_cast<size_t>(indent) * 2, ' ').push_back(object ? '}' : ']');
+	}
+}
+
+auto WriteJson(const FieldValue& value, std::string& out) -> void
+{
+	AppendJsonValue(value, out, 0);
+	out.push_back('\n');
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "FieldValue.hpp"
+
+// Read-only view of a whole file through a memory mapping
+class MappedFile
+{
+private:
+	const char* m_data = nullptr;
+	size_t m_size = 0;
+	bool m_open = false;
+#ifdef _WIN32
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#else
+	int m_fd = -1;
+#endif
+
+public:
+	explicit MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+	auto IsOpen() const -> bool { return m_open; }
+	auto Data() const -> const char* { return m_data; }
+	auto Size() const -> size_t { return m_size; }
+	auto View() const -> std::string_view { return { m_data, m_size }; }
+};
+
+// Receives each row as soon as it has been parsed. The fields may be moved from.
+using RowCallback = std::function<void(std::string_view rowName, FieldValue& fields)>;
+
+// Parses a JSON row document, one row at a time. Two layouts are accepted:
+//   { "RowName": { "Field": value, ... }, ... }
+//   [ { "Name": "RowName", "Field": value, ... }, ... ]   (the layout the editor exports)
+// Returns false and sets `error` on malformed input. Rows before the error have been delivered.
+auto ReadJsonRows(std::string_view document, const RowCallback& onRow, std::string& error) -> bool;
+
+// Parses a CSV row document. The first record is the header, its first column holds the row
+// names and the others name the fields. Cells are passed on as strings, which the scalar
+// setters convert, except cells starting with '{' or '[' which are parsed as JSON so structs,
+// arrays and maps can be written. Empty cells leave the field at its default.
+auto ReadCsvRows(std::string_view document, const RowCallback& onRow, std::string& error) -> bool;
+
+// Parses `document`, already read from `path`, as JSON or CSV depending on the path's extension
+auto ReadRowDocument(const std::filesystem::path& path, std::string_view document, const RowCallback& onRow, std::string& error) -> bool;
+
+// Appends `value` to `out` as indented JSON. Tables with string keys become objects (other keys
+// are dropped), the rest arrays. Nil becomes null.
+auto WriteJson(const FieldValue& value, std::string& out) -> void;
@@ -0,0 +1,186 @@
+/*
+ * C interface of TFWWorkbench, for native UE4SS mods that write DataTable rows without going
+ * through a Lua script. The functions are exported by the TFWWorkbench mod DLL: link against
+ * its import library, or look them up with GetModuleHandle/GetProcAddress once it is loaded.
+ *
+ * Tables and rows work as they do from Lua. The table registry is the one ConfigureDataTables
+ * fills, so handles are interchangeable. Writes go through the same queue, caches and
+ * ConfigureWorkbench settings, and are applied on the game thread by the mod's on_update.
+ * Every function may be called from any thread once the mod is loaded. Strings are UTF-8, and
+ * nothing passed in is referenced after the call returns.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#ifdef TFWWORKBENCH_EXPORTS
+#define TFWWORKBENCH_API __declspec(dllexport)
+#else
+#define TFWWORKBENCH_API __declspec(dllimport)
+#endif
+#else
+#define TFWWORKBENCH_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Bumped whenever a declaration below changes incompatibly */
+#define TFWWORKBENCH_API_VERSION 1
+
+/* Results. Functions returning a handle return a negative result on failure. */
+#define TFW_OK 0
+#define TFW_ERROR_NOT_LOADED (-1)
+#define TFW_ERROR_INVALID_ARGUMENT (-2)
+#define TFW_ERROR_UNKNOWN_TABLE (-3)
+/* The table's DataTable isn't loaded, or has no RowStruct */
+#define TFW_ERROR_UNRESOLVED_TABLE (-4)
+/* A row image doesn't match the table's RowStruct */
+#define TFW_ERROR_STRUCT_MISMATCH (-5)
+#define TFW_ERROR_EXCEPTION (-6)
+
+/* Value types, matching the Lua values the Lua API takes */
+#define TFW_VALUE_NIL 0
+#define TFW_VALUE_BOOL 1
+#define TFW_VALUE_INTEGER 2
+#define TFW_VALUE_NUMBER 3
+#define TFW_VALUE_STRING 4
+#define TFW_VALUE_TABLE 5
+
+/* How TFWWorkbench_WriteRows writes its rows */
+#define TFW_WRITE_REPLACE 0 /* AddDataTableRow: build the row from scratch */
+#define TFW_WRITE_PATCH 1   /* PatchDataTableRow: write the fields into the existing row */
+#define TFW_WRITE_UPSERT 2  /* Patch the row, or build it when there is none */
+
+typedef struct TFWEntry TFWEntry;
+
+/*
+ * A field value. Tables stand in for everything a Lua table would: structs keyed by field
+ * name, arrays keyed by the integers 1..n in order, maps, and FText as
+ * { namespace, key, text }.
+ */
+typedef struct TFWValue
+{
+	int32_t type;
+	union
+	{
+		int32_t boolean;
+		int64_t integer;
+		double number;
+		struct TFWStringValue
+		{
+			const char* data;
+			size_t size;
+		} string;
+		struct TFWTableValue
+		{
+			const TFWEntry* entries;
+			size_t count;
+		} table;
+	} as;
+} TFWValue;
+
+struct TFWEntry
+{
+	TFWValue key;
+	TFWValue value;
+};
+
+typedef struct TFWRow
+{
+	const char* name;
+	const TFWEntry* fields;
+	size_t fieldCount;
+} TFWRow;
+
+static inline TFWValue TFWBool(int32_t value)
+{
+	TFWValue result;
+	result.type = TFW_VALUE_BOOL;
+	result.as.boolean = value;
+	return result;
+}
+
+static inline TFWValue TFWInteger(int64_t value)
+{
+	TFWValue result;
+	result.type = TFW_VALUE_INTEGER;
+	result.as.integer = value;
+	return result;
+}
+
+static inline TFWValue TFWNumber(double value)
+{
+	TFWValue result;
+	result.type = TFW_VALUE_NUMBER;
+	result.as.number = value;
+	return result;
+}
+
+static inline TFWValue TFWString(const char* value)
+{
+	TFWValue result;
+	result.type = TFW_VALUE_STRING;
+	result.as.string.data = value;
+	result.as.string.size = value ? strlen(value) : 0;
+	return result;
+}
+
+static inline TFWValue TFWTable(const TFWEntry* entries, size_t count)
+{
+	TFWValue result;
+	result.type = TFW_VALUE_TABLE;
+	result.as.table.entries = entries;
+	result.as.table.count = count;
+	return result;
+}
+
+/* The entry of field `name` of a struct */
+static inline TFWEntry TFWField(const char* name, TFWValue value)
+{
+	TFWEntry result;
+	result.key = TFWString(name);
+	result.value = value;
+	return result;
+}
+
+/* TFWWORKBENCH_API_VERSION of the loaded mod */
+TFWWORKBENCH_API int32_t TFWWorkbench_GetApiVersion(void);
+
+/* ConfigureDataTables(name, path). Returns the table's handle. */
+TFWWORKBENCH_API int32_t TFWWorkbench_ConfigureTable(const char* name, const char* path);
+
+/* Returns the handle of a configured table, or TFW_ERROR_UNKNOWN_TABLE */
+TFWWORKBENCH_API int32_t TFWWorkbench_FindTable(const char* name);
+
+/*
+ * Queues `count` rows of `table`, each built from its field entries as the Lua API would from
+ * a table, in `mode` (TFW_WRITE_*). Either every row is queued or, on failure, none is. Rows
+ * of a table that isn't loaded yet wait for it.
+ */
+TFWWORKBENCH_API int32_t TFWWorkbench_WriteRows(int32_t table, const TFWRow* rows, size_t count, int32_t mode);
+
+/*
+ * Queues `count` rows of `table` that are copies of ready-made row structs, skipping every
+ * per-field conversion. `images` holds the rows back to back, `imageSize` bytes apart, which
+ * must be the size of the table's RowStruct. When `rowStruct` isn't NULL it must be that
+ * UScriptStruct. The images are copied with UScriptStruct::CopyScriptStruct before returning,
+ * so they can be destroyed right after the call. Rows of a table that isn't loaded yet wait for
+ * it like other writes, which needs `rowStruct` to copy them: without it the call fails with
+ * TFW_ERROR_UNRESOLVED_TABLE. A mismatch found once the table has loaded fails those rows.
+ */
+TFWWORKBENCH_API int32_t TFWWorkbench_AddRowImages(int32_t table,
+	const void* rowStruct,
+	const char* const* rowNames,
+	const void* images,
+	size_t imageSize,
+	size_t count);
+
+#ifdef __cplusplus
+}
+#endif
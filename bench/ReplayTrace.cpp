@@ -0,0 +1,516 @@
+// Replays a call trace captured with ConfigureWorkbench{ captureFile = ... } against the mod
+// outside the game, so a user's exact mix of mods can be measured and profiled:
+//
+//   TFWWorkbenchReplay <trace> [--csv calls.csv]
+//
+// The row structs and tables are rebuilt from the layouts in the trace, as stand-in types from
+// mock/, before the first call. Every recorded call is then made again in order through the
+// same Lua entry points, with each on_update at the point it ran in the game, and timed. The
+// Lua tables for the writes are built up front, so the times cover what the mod does with them.
+// Tables whose layout was never recorded (they didn't resolve while capturing) are left out,
+// and writes to them wait like they would for a table that never loads.
+
+#include <Mod/CppUserModBase.hpp>
+#include <Unreal/Engine/UDataTable.hpp>
+#include <Unreal/Property/FArrayProperty.hpp>
+#include <Unreal/Property/FMapProperty.hpp>
+#include <Unreal/Property/FStructProperty.hpp>
+#include <LuaMadeSimple/LuaMadeSimple.hpp>
+
+#include "CallTrace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace RC;
+using namespace RC::Unreal;
+
+extern "C" RC::CppUserModBase* start_mod();
+extern "C" void uninstall_mod(RC::CppUserModBase* mod);
+
+namespace
+{
+	auto FindField(const FieldValue& table, std::string_view key) -> const FieldValue*
+	{
+		if (!table.is_table()) return nullptr;
+		for (const FieldValue::Entry& entry : table.get_table())
+		{
+			if (entry.key.is_string() && entry.key.get_string() == key) return &entry.value;
+		}
+		return nullptr;
+	}
+
+	auto StringField(const FieldValue& table, std::string_view key) -> std::string_view
+	{
+		const FieldValue* value = FindField(table, key);
+		return value && value->is_string() ? value->get_string() : std::string_view();
+	}
+
+	auto PushFieldValue(lua_State* L, const FieldValue& value) -> void
+	{
+		switch (value.get_type())
+		{
+		case FieldValue::Type::Bool: lua_pushboolean(L, value.get_bool()); break;
+		case FieldValue::Type::Integer: lua_pushinteger(L, static_cast<lua_Integer>(value.get_integer())); break;
+		case FieldValue::Type::Number: lua_pushnumber(L, value.get_number()); break;
+		case FieldValue::Type::String: lua_pushlstring(L, value.get_string().data(), value.get_string().size()); break;
+		case FieldValue::Type::Table:
+			lua_createtable(L, 0, static_cast<int>(value.get_table().size()));
+			for (const FieldValue::Entry& entry : value.get_table())
+			{
+				if (entry.key.is_nil()) continue;
+				PushFieldValue(L, entry.key);
+				PushFieldValue(L, entry.value);
+				lua_settable(L, -3);
+			}
+			break;
+		default: lua_pushnil(L); break;
+		}
+	}
+
+	// Rebuilds the row structs of the traced tables from their recorded layouts
+	class LayoutBuilder
+	{
+	private:
+		std::vector<std::unique_ptr<UScriptStruct>>& m_structs;
+		std::unordered_map<std::string, UScriptStruct*> m_built;
+		const FieldValue* m_descriptions = nullptr;
+
+	public:
+		explicit LayoutBuilder(std::vector<std::unique_ptr<UScriptStruct>>& structs) : m_structs(structs) {}
+
+		auto BuildRowStruct(const FieldValue& layout) -> UScriptStruct*
+		{
+			m_descriptions = FindField(layout, "structs");
+			return BuildStruct(StringField(layout, "row"));
+		}
+
+	private:
+		auto BuildStruct(std::string_view path) -> UScriptStruct*
+		{
+			if (path.empty()) return nullptr;
+			auto found = m_built.find(std::string(path));
+			if (found != m_built.end()) return found->second;
+
+			const FieldValue* description = m_descriptions ? FindField(*m_descriptions, path) : nullptr;
+			if (!description) return nullptr;
+
+			auto scriptStruct = std::make_unique<UScriptStruct>(to_wstring(path));
+			UScriptStruct* result = scriptStruct.get();
+			m_built.emplace(std::string(path), result);
+			m_structs.push_back(std::move(scriptStruct));
+
+			if (const FieldValue* fields = FindField(*description, "fields"); fields && fields->is_table())
+			{
+				for (const FieldValue::Entry& field : fields->get_table())
+				{
+					if (auto property = BuildProperty(field.value)) result->AddProperty(std::move(property));
+				}
+			}
+			return result;
+		}
+
+		// The integer type an enum of `size` bytes is stored as
+		static auto EnumUnderlying(const StringType& name, int64_t size) -> std::unique_ptr<FNumericProperty>
+		{
+			switch (size)
+			{
+			case 2: return std::make_unique<FUInt16Property>(name);
+			case 4: return std::make_unique<FIntProperty>(name);
+			case 8: return std::make_unique<FInt64Property>(name);
+			default: return std::make_unique<FByteProperty>(name);
+			}
+		}
+
+		auto BuildProperty(const FieldValue& field) -> std::unique_ptr<FProperty>
+		{
+			StringType name = to_wstring(StringField(field, "name"));
+			std::string_view kind = StringField(field, "kind");
+			const FieldValue* size = FindField(field, "size");
+			int64_t sizeBytes = size ? size->get_integer() : 0;
+
+			if (kind == "Text") return std::make_unique<FTextProperty>(name);
+			if (kind == "Str") return std::make_unique<FStrProperty>(name);
+			if (kind == "Name") return std::make_unique<FNameProperty>(name);
+			if (kind == "Bool") return std::make_unique<FBoolProperty>(name);
+			if (kind == "SoftObject") return std::make_unique<FSoftObjectProperty>(name);
+			if (kind == "Object") return std::make_unique<FObjectProperty>(name);
+			if (kind == "Enum") return std::make_unique<FEnumProperty>(name, EnumUnderlying(name, sizeBytes));
+			if (kind == "Int8") return std::make_unique<FInt8Property>(name);
+			if (kind == "Int16") return std::make_unique<FInt16Property>(name);
+			if (kind == "Int") return std::make_unique<FIntProperty>(name);
+			if (kind == "Int64") return std::make_unique<FInt64Property>(name);
+			if (kind == "Byte") return std::make_unique<FByteProperty>(name);
+			if (kind == "UInt16") return std::make_unique<FUInt16Property>(name);
+			if (kind == "UInt32") return std::make_unique<FUInt32Property>(name);
+			if (kind == "UInt64") return std::make_unique<FUInt64Property>(name);
+			if (kind == "Float") return std::make_unique<FFloatProperty>(name);
+			if (kind == "Double") return std::make_unique<FDoubleProperty>(name);
+			if (kind == "Struct")
+			{
+				UScriptStruct* scriptStruct = BuildStruct(StringField(field, "struct"));
+				if (!scriptStruct) return nullptr;
+				return std::make_unique<FStructProperty>(name, scriptStruct);
+			}
+			if (kind == "Array")
+			{
+				const FieldValue* inner = FindField(field, "inner");
+				auto innerProperty = inner ? BuildProperty(*inner) : nullptr;
+				if (!innerProperty) return nullptr;
+				return std::make_unique<FArrayProperty>(name, std::move(innerProperty));
+			}
+			if (kind == "Map")
+			{
+				const FieldValue* key = FindField(field, "inner");
+				const FieldValue* value = FindField(field, "value");
+				auto keyProperty = key ? BuildProperty(*key) : nullptr;
+				auto valueProperty = value ? BuildProperty(*value) : nullptr;
+				if (!keyProperty || !valueProperty) return nullptr;
+				return std::make_unique<FMapProperty>(name, std::move(keyProperty), std::move(valueProperty));
+			}
+			// Unsupported fields were never written, so leaving them out changes nothing
+			return nullptr;
+		}
+	};
+
+	// One call to make again: a Lua function and its arguments, or an on_update
+	struct ReplayCall
+	{
+		std::string kind;
+		std::string table;
+		size_t rows = 0;
+		std::vector<int> args;
+	};
+
+	struct CallSummary
+	{
+		size_t count = 0;
+		size_t rows = 0;
+		double totalMs = 0.0;
+		double maxMs = 0.0;
+
+		auto Add(size_t callRows, double ms) -> void
+		{
+			count++;
+			rows += callRows;
+			totalMs += ms;
+			maxMs = std::max(maxMs, ms);
+		}
+	};
+
+	class Replay
+	{
+	private:
+		std::vector<std::unique_ptr<UScriptStruct>> m_structs;
+		std::vector<std::unique_ptr<UDataTable>> m_tables;
+		std::vector<ReplayCall> m_calls;
+
+		CppUserModBase* m_mod = nullptr;
+		lua_State* m_lua_state = nullptr;
+
+	public:
+		Replay()
+		{
+			m_mod = start_mod();
+			m_mod->on_unreal_init();
+
+			m_lua_state = luaL_newstate();
+			luaL_openlibs(m_lua_state);
+			LuaMadeSimple::Lua lua(m_lua_state);
+			m_mod->on_lua_start(lua, lua, lua, nullptr);
+		}
+
+		~Replay()
+		{
+			lua_close(m_lua_state);
+			uninstall_mod(m_mod);
+		}
+
+		// Creates the tables and turns every record into the calls that repeat it
+		auto Load(const CallTraceFile& trace) -> bool
+		{
+			std::unordered_map<std::string, std::string> tablePaths;
+			std::unordered_set<std::string> created;
+			for (const CallRecord& record : trace.Records())
+			{
+				CallRecordReader reader(record.payload);
+				std::string_view name;
+				if (record.kind == CallRecordKind::ConfigureTable)
+				{
+					std::string_view path;
+					if (!reader.ReadString(name) || !reader.ReadString(path)) return false;
+					tablePaths[std::string(name)] = std::string(path);
+				}
+				else if (record.kind == CallRecordKind::TableLayout)
+				{
+					FieldValue layout;
+					if (!reader.ReadString(name) || !reader.ReadValue(layout)) return false;
+					auto path = tablePaths.find(std::string(name));
+					if (path == tablePaths.end() || !created.insert(path->second).second) continue;
+
+					UScriptStruct* rowStruct = LayoutBuilder(m_structs).BuildRowStruct(layout);
+					if (rowStruct) m_tables.push_back(std::make_unique<UDataTable>(to_wstring(path->second), rowStruct));
+				}
+			}
+
+			for (const CallRecord& record : trace.Records())
+			{
+				if (!AddCalls(record)) return false;
+			}
+			return true;
+		}
+
+		auto Run(const char* csvPath) -> void
+		{
+			std::map<std::string, CallSummary> byKind;
+			std::map<std::string, CallSummary> byTable;
+			std::ofstream csv;
+			if (csvPath)
+			{
+				csv.open(csvPath);
+				csv << "call,table,rows,ms\n";
+			}
+
+			for (const ReplayCall& call : m_calls)
+			{
+				double ms = Time(call);
+				byKind[call.kind].Add(call.rows, ms);
+				if (!call.table.empty()) byTable[call.table].Add(call.rows, ms);
+				if (csv.is_open()) csv << call.kind << ',' << call.table << ',' << call.rows << ',' << ms << '\n';
+			}
+
+			// Whatever the last frames of the session left queued
+			CallSummary drain;
+			for (int frame = 0; frame < 10000 && PendingWrites() > 0; frame++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				m_mod->on_update();
+				drain.Add(0, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+			}
+			if (drain.count > 0) byKind["on_update (drain)"] = drain;
+
+			std::printf("%-28s %8s %10s %12s %10s %10s\n", "call", "count", "rows", "total ms", "mean ms", "max ms");
+			Print(byKind);
+			std::printf("\n%-28s %8s %10s %12s %10s %10s\n", "table", "calls", "rows", "total ms", "mean ms", "max ms");
+			Print(byTable);
+		}
+
+	private:
+		auto Ref(const FieldValue& value) -> int
+		{
+			PushFieldValue(m_lua_state, value);
+			return luaL_ref(m_lua_state, LUA_REGISTRYINDEX);
+		}
+
+		auto RefString(std::string_view value) -> int
+		{
+			lua_pushlstring(m_lua_state, value.data(), value.size());
+			return luaL_ref(m_lua_state, LUA_REGISTRYINDEX);
+		}
+
+		auto AddCalls(const CallRecord& record) -> bool
+		{
+			CallRecordReader reader(record.payload);
+			switch (record.kind)
+			{
+			case CallRecordKind::ConfigureTable:
+			{
+				std::string_view name;
+				std::string_view path;
+				if (!reader.ReadString(name) || !reader.ReadString(path)) return false;
+				m_calls.push_back({ "ConfigureDataTables", std::string(name), 0, { RefString(name), RefString(path) } });
+				return true;
+			}
+			case CallRecordKind::Configure:
+			{
+				FieldValue options;
+				if (!reader.ReadValue(options)) return false;
+				// Nothing of the replay is captured or written out again
+				std::erase_if(options.get_table(), [](const FieldValue::Entry& option) {
+					return option.key.get_string().ends_with("File");
+				});
+				m_calls.push_back({ "ConfigureWorkbench", "", 0, { Ref(options) } });
+				return true;
+			}
+			case CallRecordKind::TableLayout:
+				return true;
+			case CallRecordKind::Update:
+				m_calls.push_back({ "on_update", "", 0, {} });
+				return true;
+			case CallRecordKind::Writes:
+				return AddWriteCalls(reader);
+			}
+			return false;
+		}
+
+		// A batch of replaced rows goes through AddDataTableRows, split where a row name repeats
+		// since a Lua table can't hold it twice. The other modes have a call per row.
+		auto AddWriteCalls(CallRecordReader& reader) -> bool
+		{
+			std::string_view table;
+			uint32_t count = 0;
+			if (!reader.ReadString(table) || !reader.ReadU32(count)) return false;
+
+			FieldValue batch = FieldValue::make_table();
+			std::unordered_set<std::string_view> batchRows;
+			auto flushBatch = [&]() {
+				if (batchRows.empty()) return;
+				if (batchRows.size() == 1)
+				{
+					const FieldValue::Entry& row = batch.get_table().front();
+					m_calls.push_back({ "AddDataTableRow", std::string(table), 1, { RefString(table), Ref(row.key), Ref(row.value) } });
+				}
+				else
+				{
+					m_calls.push_back({ "AddDataTableRows", std::string(table), batchRows.size(), { RefString(table), Ref(batch) } });
+				}
+				batch = FieldValue::make_table();
+				batchRows.clear();
+			};
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				uint8_t mode = 0;
+				std::string_view rowName;
+				std::string_view sourceRow;
+				FieldValue fields;
+				if (!reader.ReadU8(mode) || !reader.ReadString(rowName) || !reader.ReadString(sourceRow) || !reader.ReadValue(fields))
+				{
+					return false;
+				}
+
+				switch (static_cast<CallWriteMode>(mode))
+				{
+				case CallWriteMode::Replace:
+					if (!batchRows.insert(rowName).second)
+					{
+						flushBatch();
+						batchRows.insert(rowName);
+					}
+					batch.add(FieldValue::from_string(rowName), std::move(fields));
+					break;
+				case CallWriteMode::Patch:
+				case CallWriteMode::Upsert:
+				{
+					flushBatch();
+					bool upsert = static_cast<CallWriteMode>(mode) == CallWriteMode::Upsert;
+					m_calls.push_back({
+						"PatchDataTableRow",
+						std::string(table),
+						1,
+						{ RefString(table), RefString(rowName), Ref(fields), Ref(FieldValue::from_bool(upsert)) }
+					});
+					break;
+				}
+				case CallWriteMode::Clone:
+					flushBatch();
+					m_calls.push_back({
+						"CloneDataTableRow",
+						std::string(table),
+						1,
+						{ RefString(table), RefString(sourceRow), RefString(rowName), Ref(fields) }
+					});
+					break;
+				default:
+					return false;
+				}
+			}
+			flushBatch();
+			return true;
+		}
+
+		auto Time(const ReplayCall& call) -> double
+		{
+			if (call.kind == "on_update")
+			{
+				auto start = std::chrono::steady_clock::now();
+				m_mod->on_update();
+				return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			}
+
+			lua_State* L = m_lua_state;
+			lua_getglobal(L, call.kind.c_str());
+			for (int arg : call.args) lua_rawgeti(L, LUA_REGISTRYINDEX, arg);
+
+			auto start = std::chrono::steady_clock::now();
+			int status = lua_pcall(L, static_cast<int>(call.args.size()), 0, 0);
+			double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (status != LUA_OK)
+			{
+				std::fprintf(stderr, "%s failed: %s\n", call.kind.c_str(), lua_tostring(L, -1));
+				lua_pop(L, 1);
+			}
+			return ms;
+		}
+
+		auto PendingWrites() -> lua_Integer
+		{
+			lua_State* L = m_lua_state;
+			lua_getglobal(L, "GetWorkbenchStats");
+			if (lua_pcall(L, 0, 1, 0) != LUA_OK || !lua_istable(L, -1))
+			{
+				lua_pop(L, 1);
+				return 0;
+			}
+			lua_getfield(L, -1, "pendingWrites");
+			lua_Integer pending = lua_tointeger(L, -1);
+			lua_pop(L, 2);
+			return pending;
+		}
+
+		static auto Print(const std::map<std::string, CallSummary>& summaries) -> void
+		{
+			for (const auto& [name, summary] : summaries)
+			{
+				std::printf(
+					"%-28s %8zu %10zu %12.3f %10.4f %10.4f\n",
+					name.c_str(), summary.count, summary.rows, summary.totalMs,
+					summary.totalMs / static_cast<double>(summary.count), summary.maxMs
+				);
+			}
+		}
+	};
+}
+
+int main(int argc, char** argv)
+{
+	const char* tracePath = nullptr;
+	const char* csvPath = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string_view arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc) csvPath = argv[++i];
+		else tracePath = argv[i];
+	}
+	if (!tracePath)
+	{
+		std::fprintf(stderr, "usage: %s <trace> [--csv calls.csv]\n", argv[0]);
+		return 2;
+	}
+
+	CallTraceFile trace(tracePath);
+	if (!trace.IsValid())
+	{
+		std::fprintf(stderr, "%s is not a call trace\n", tracePath);
+		return 1;
+	}
+
+	Replay replay;
+	if (!replay.Load(trace))
+	{
+		std::fprintf(stderr, "%s has a malformed record\n", tracePath);
+		return 1;
+	}
+	replay.Run(csvPath);
+	return 0;
+}
@@ -0,0 +1,590 @@
+// Rows/sec of the row writer, driven through the same Lua entry points mods call.
+//
+// Every benchmark queues a batch of rows from Lua with AddDataTableRows (or ImportDataTableRows)
+// and then runs on_update until the queue is drained, so the numbers cover marshalling, queueing
+// and the property writes. The row tables are built once per batch size, outside the timed loop.
+// Rows keep their names between iterations, so after the first one every write replaces a row.
+// The second argument is the number of build workers, 0 builds every row on the calling thread.
+// The Native benchmarks queue the same rows through the C API in TFWWorkbenchApi.h instead.
+
+#include <benchmark/benchmark.h>
+
+#include <Mod/CppUserModBase.hpp>
+#include <Unreal/Engine/UDataTable.hpp>
+#include <Unreal/Property/FArrayProperty.hpp>
+#include <Unreal/Property/FMapProperty.hpp>
+#include <Unreal/Property/FStructProperty.hpp>
+#include <LuaMadeSimple/LuaMadeSimple.hpp>
+
+#include "TFWWorkbenchApi.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace RC;
+using namespace RC::Unreal;
+
+extern "C" RC::CppUserModBase* start_mod();
+extern "C" void uninstall_mod(RC::CppUserModBase* mod);
+
+namespace
+{
+	// Builds the row tables for each benchmark. MakeRows(kind, count) stores them in the global Rows.
+	constexpr const char* RowScript = R"lua(
+		local builders = {}
+
+		builders.Flat = function(i)
+			return {
+				Damage = i % 200,
+				Weight = i * 0.25,
+				Stackable = i % 2 == 0,
+				Price = i * 1.5,
+				Category = "Category_" .. (i % 16),
+				Description = "Item description " .. i,
+				Rarity = i % 5,
+				Icon = "/Game/UI/Icons/T_Item_" .. i .. ".T_Item_" .. i,
+			}
+		end
+
+		builders.StructArray = function(i)
+			local ingredients = {}
+			for j = 1, 8 do
+				ingredients[j] = { Item = "Item_" .. ((i + j) % 64), Count = j, Chance = j / 8 }
+			end
+			return { Id = "Recipe_" .. i, Ingredients = ingredients, CraftTime = i % 30 }
+		end
+
+		builders.Map = function(i)
+			local items = {}
+			for j = 1, 8 do
+				items["Item_" .. ((i * 8 + j) % 256)] = { Price = j * 10, Stock = j }
+			end
+			return { Items = items, Restock = i % 7 }
+		end
+
+		builders.Curve = function(i)
+			local curve, weights = {}, {}
+			for j = 1, 256 do
+				curve[j] = (i + j) * 0.125
+				weights[j] = (i * j) % 100
+			end
+			return { Curve = curve, DropWeights = weights, Level = i % 60 }
+		end
+
+		builders.Text = function(i)
+			return {
+				DisplayName = "Item " .. i,
+				Description = { namespace = "Items", key = "Desc_" .. i, text = "Description of item " .. i },
+				Flavor = { table = "ST_Flavor", key = "Flavor_" .. (i % 32) },
+				Tooltip = "Tooltip for item " .. i,
+			}
+		end
+
+		-- Derives `count` rows from Row_1 of the Flat table, the way item mods clone a vanilla item
+		function CloneRows(count)
+			for i = 1, count do
+				CloneDataTableRow("Flat", "Row_1", "Clone_" .. i, { Damage = i % 200, Description = "Clone " .. i })
+			end
+		end
+
+		-- Looks up the rows of every category, `count` times over
+		function FindRows(count)
+			for i = 1, count do
+				FindDataTableRows("Flat", "Category", "Category_" .. (i % 16))
+			end
+		end
+
+		-- Changes one field of Row_1, the way a reloaded config script usually differs
+		function TouchRow()
+			Rows.Row_1.Damage = (Rows.Row_1.Damage + 1) % 200
+		end
+
+		function MakeRows(kind, count)
+			local build = builders[kind]
+			Rows = {}
+			for i = 1, count do
+				Rows["Row_" .. i] = build(i)
+			end
+		end
+	)lua";
+
+	// Owns the mod, a Lua state it's registered on, and the row structs and tables it writes to
+	class Workbench
+	{
+	private:
+		std::unique_ptr<UScriptStruct> m_flat_row;
+		std::unique_ptr<UScriptStruct> m_ingredient;
+		std::unique_ptr<UScriptStruct> m_recipe_row;
+		std::unique_ptr<UScriptStruct> m_vendor_entry;
+		std::unique_ptr<UScriptStruct> m_vendor_row;
+		std::unique_ptr<UScriptStruct> m_text_row;
+		std::unique_ptr<UScriptStruct> m_curve_row;
+		std::unique_ptr<UDataTable> m_flat_table;
+		std::unique_ptr<UDataTable> m_recipe_table;
+		std::unique_ptr<UDataTable> m_vendor_table;
+		std::unique_ptr<UDataTable> m_text_table;
+		std::unique_ptr<UDataTable> m_curve_table;
+
+		CppUserModBase* m_mod = nullptr;
+		lua_State* m_lua_state = nullptr;
+		std::filesystem::path m_temp_dir;
+
+	public:
+		Workbench()
+		{
+			BuildStructs();
+
+			m_flat_table = std::make_unique<UDataTable>(STR("/Game/Bench/DT_Flat.DT_Flat"), m_flat_row.get());
+			m_recipe_table = std::make_unique<UDataTable>(STR("/Game/Bench/DT_Recipes.DT_Recipes"), m_recipe_row.get());
+			m_vendor_table = std::make_unique<UDataTable>(STR("/Game/Bench/DT_Vendors.DT_Vendors"), m_vendor_row.get());
+			m_text_table = std::make_unique<UDataTable>(STR("/Game/Bench/DT_Text.DT_Text"), m_text_row.get());
+			m_curve_table = std::make_unique<UDataTable>(STR("/Game/Bench/DT_Curves.DT_Curves"), m_curve_row.get());
+
+			m_temp_dir = std::filesystem::temp_directory_path() / "TFWWorkbenchBench";
+			std::filesystem::remove_all(m_temp_dir);
+			std::filesystem::create_directories(m_temp_dir);
+
+			m_mod = start_mod();
+			m_mod->on_unreal_init();
+
+			m_lua_state = luaL_newstate();
+			luaL_openlibs(m_lua_state);
+			LuaMadeSimple::Lua lua(m_lua_state);
+			m_mod->on_lua_start(lua, lua, lua, nullptr);
+
+			Run(RowScript);
+			Run(R"lua(
+				ConfigureDataTables("Flat", "/Game/Bench/DT_Flat.DT_Flat")
+				ConfigureDataTables("StructArray", "/Game/Bench/DT_Recipes.DT_Recipes")
+				ConfigureDataTables("Map", "/Game/Bench/DT_Vendors.DT_Vendors")
+				ConfigureDataTables("Text", "/Game/Bench/DT_Text.DT_Text")
+				ConfigureDataTables("Curve", "/Game/Bench/DT_Curves.DT_Curves")
+			)lua");
+			// Each batch is drained in a single on_update
+			Configure(false);
+		}
+
+		~Workbench()
+		{
+			lua_close(m_lua_state);
+			uninstall_mod(m_mod);
+			std::error_code ec;
+			std::filesystem::remove_all(m_temp_dir, ec);
+		}
+
+		static auto Get() -> Workbench&
+		{
+			static Workbench workbench;
+			return workbench;
+		}
+
+		auto TempDir() const -> const std::filesystem::path& { return m_temp_dir; }
+		auto FlatTable() const -> UDataTable* { return m_flat_table.get(); }
+
+		auto Update() -> void
+		{
+			m_mod->on_update();
+		}
+
+		auto Run(const char* chunk) -> void
+		{
+			if (luaL_dostring(m_lua_state, chunk) != LUA_OK)
+			{
+				std::fprintf(stderr, "Lua error: %s\n", lua_tostring(m_lua_state, -1));
+				std::abort();
+			}
+			lua_settop(m_lua_state, 0);
+		}
+
+		auto Configure(bool rowCache) -> void
+		{
+			std::string chunk = "ConfigureWorkbench({ frameBudgetMs = 1000000, rowCache = ";
+			chunk += rowCache ? "true" : "false";
+			chunk += ", rowCacheDir = [[" + (m_temp_dir / "rowcache").string() + "]] })";
+			Run(chunk.c_str());
+		}
+
+		auto SetBuildThreads(int64_t count) -> void
+		{
+			Run(("ConfigureWorkbench({ buildThreads = " + std::to_string(count) + " })").c_str());
+		}
+
+		auto MakeRows(const char* kind, int64_t count) -> void
+		{
+			lua_getglobal(m_lua_state, "MakeRows");
+			lua_pushstring(m_lua_state, kind);
+			lua_pushinteger(m_lua_state, count);
+			Call(2);
+		}
+
+		// Queues the rows built by MakeRows into `table` and writes them
+		auto AddRows(const char* table) -> void
+		{
+			lua_getglobal(m_lua_state, "AddDataTableRows");
+			lua_pushstring(m_lua_state, table);
+			lua_getglobal(m_lua_state, "Rows");
+			Call(2);
+			m_mod->on_update();
+		}
+
+		// Queues CloneRows(count) and writes the clones
+		auto CloneRows(int64_t count) -> void
+		{
+			lua_getglobal(m_lua_state, "CloneRows");
+			lua_pushinteger(m_lua_state, count);
+			Call(1);
+			m_mod->on_update();
+		}
+
+		// Runs FindRows(count)
+		auto FindRows(int64_t count) -> void
+		{
+			lua_getglobal(m_lua_state, "FindRows");
+			lua_pushinteger(m_lua_state, count);
+			Call(1);
+		}
+
+		auto ImportRows(const char* table, const std::filesystem::path& path) -> void
+		{
+			lua_getglobal(m_lua_state, "ImportDataTableRows");
+			lua_pushstring(m_lua_state, table);
+			lua_pushstring(m_lua_state, path.string().c_str());
+			Call(2);
+			m_mod->on_update();
+		}
+
+	private:
+		auto Call(int argCount) -> void
+		{
+			if (lua_pcall(m_lua_state, argCount, 1, 0) != LUA_OK)
+			{
+				std::fprintf(stderr, "Lua error: %s\n", lua_tostring(m_lua_state, -1));
+				std::abort();
+			}
+			lua_settop(m_lua_state, 0);
+		}
+
+		auto BuildStructs() -> void
+		{
+			m_flat_row = std::make_unique<UScriptStruct>(STR("/Script/Bench.FlatRow"));
+			m_flat_row->AddProperty<FIntProperty>(STR("Damage"));
+			m_flat_row->AddProperty<FFloatProperty>(STR("Weight"));
+			m_flat_row->AddProperty<FBoolProperty>(STR("Stackable"));
+			m_flat_row->AddProperty<FDoubleProperty>(STR("Price"));
+			m_flat_row->AddProperty<FNameProperty>(STR("Category"));
+			m_flat_row->AddProperty<FStrProperty>(STR("Description"));
+			m_flat_row->AddProperty<FEnumProperty>(STR("Rarity"), std::make_unique<FByteProperty>(STR("UnderlyingType")));
+			m_flat_row->AddProperty<FSoftObjectProperty>(STR("Icon"));
+
+			m_ingredient = std::make_unique<UScriptStruct>(STR("/Script/Bench.Ingredient"));
+			m_ingredient->AddProperty<FNameProperty>(STR("Item"));
+			m_ingredient->AddProperty<FIntProperty>(STR("Count"));
+			m_ingredient->AddProperty<FFloatProperty>(STR("Chance"));
+
+			m_recipe_row = std::make_unique<UScriptStruct>(STR("/Script/Bench.RecipeRow"));
+			m_recipe_row->AddProperty<FNameProperty>(STR("Id"));
+			m_recipe_row->AddProperty<FArrayProperty>(STR("Ingredients"), std::make_unique<FStructProperty>(STR("Ingredients"), m_ingredient.get()));
+			m_recipe_row->AddProperty<FIntProperty>(STR("CraftTime"));
+
+			m_vendor_entry = std::make_unique<UScriptStruct>(STR("/Script/Bench.VendorEntry"));
+			m_vendor_entry->AddProperty<FIntProperty>(STR("Price"));
+			m_vendor_entry->AddProperty<FIntProperty>(STR("Stock"));
+
+			m_vendor_row = std::make_unique<UScriptStruct>(STR("/Script/Bench.VendorRow"));
+			m_vendor_row->AddProperty<FMapProperty>(STR("Items"),
+				std::make_unique<FNameProperty>(STR("Items_Key")),
+				std::make_unique<FStructProperty>(STR("Items"), m_vendor_entry.get()));
+			m_vendor_row->AddProperty<FIntProperty>(STR("Restock"));
+
+			m_text_row = std::make_unique<UScriptStruct>(STR("/Script/Bench.TextRow"));
+			m_text_row->AddProperty<FTextProperty>(STR("DisplayName"));
+			m_text_row->AddProperty<FTextProperty>(STR("Description"));
+			m_text_row->AddProperty<FTextProperty>(STR("Flavor"));
+			m_text_row->AddProperty<FTextProperty>(STR("Tooltip"));
+
+			m_curve_row = std::make_unique<UScriptStruct>(STR("/Script/Bench.CurveRow"));
+			m_curve_row->AddProperty<FArrayProperty>(STR("Curve"), std::make_unique<FFloatProperty>(STR("Curve")));
+			m_curve_row->AddProperty<FArrayProperty>(STR("DropWeights"), std::make_unique<FByteProperty>(STR("DropWeights")));
+			m_curve_row->AddProperty<FIntProperty>(STR("Level"));
+		}
+	};
+
+	auto AddRowsBenchmark(benchmark::State& state, const char* kind) -> void
+	{
+		Workbench& workbench = Workbench::Get();
+		workbench.MakeRows(kind, state.range(0));
+		workbench.SetBuildThreads(state.range(1));
+
+		for (auto _ : state)
+		{
+			workbench.AddRows(kind);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Clones of one flat row with two fields overridden, against BM_FlatRows writing all eight
+	auto CloneBenchmark(benchmark::State& state) -> void
+	{
+		Workbench& workbench = Workbench::Get();
+		workbench.MakeRows("Flat", 1);
+		workbench.AddRows("Flat");
+		workbench.SetBuildThreads(state.range(1));
+
+		for (auto _ : state)
+		{
+			workbench.CloneRows(state.range(0));
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// The same flat rows written again with one field changed, with and without incrementalWrites
+	auto ReapplyBenchmark(benchmark::State& state, bool incremental) -> void
+	{
+		Workbench& workbench = Workbench::Get();
+		workbench.Run(incremental ? "ConfigureWorkbench({ incrementalWrites = true })" : "ConfigureWorkbench({ incrementalWrites = false })");
+		workbench.MakeRows("Flat", state.range(0));
+		workbench.SetBuildThreads(state.range(1));
+		workbench.AddRows("Flat");
+
+		for (auto _ : state)
+		{
+			workbench.Run("TouchRow()");
+			workbench.AddRows("Flat");
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+
+		workbench.Run("ConfigureWorkbench({ incrementalWrites = false })");
+	}
+
+	// Queries of a flat table by category, the first of which builds the index
+	auto FindBenchmark(benchmark::State& state) -> void
+	{
+		Workbench& workbench = Workbench::Get();
+		workbench.MakeRows("Flat", state.range(0));
+		workbench.SetBuildThreads(0);
+		workbench.AddRows("Flat");
+
+		for (auto _ : state)
+		{
+			workbench.FindRows(1024);
+		}
+		state.SetItemsProcessed(state.iterations() * 1024);
+	}
+
+	// The flat rows of builders.Flat as C API field entries
+	struct NativeFlatRows
+	{
+		std::vector<std::string> names;
+		std::vector<std::string> strings;
+		std::vector<TFWEntry> fields;
+		std::vector<TFWRow> rows;
+
+		explicit NativeFlatRows(int64_t count)
+		{
+			constexpr size_t FieldCount = 8;
+			names.reserve(count);
+			strings.reserve(count * 3);
+			fields.reserve(count * FieldCount);
+			for (int64_t i = 1; i <= count; i++)
+			{
+				names.push_back("Row_" + std::to_string(i));
+				strings.push_back("Category_" + std::to_string(i % 16));
+				strings.push_back("Item description " + std::to_string(i));
+				strings.push_back("/Game/UI/Icons/T_Item_" + std::to_string(i) + ".T_Item_" + std::to_string(i));
+				const std::string* text = &strings[strings.size() - 3];
+
+				fields.push_back(TFWField("Damage", TFWInteger(i % 200)));
+				fields.push_back(TFWField("Weight", TFWNumber(i * 0.25)));
+				fields.push_back(TFWField("Stackable", TFWBool(i % 2 == 0)));
+				fields.push_back(TFWField("Price", TFWNumber(i * 1.5)));
+				fields.push_back(TFWField("Category", TFWString(text[0].c_str())));
+				fields.push_back(TFWField("Description", TFWString(text[1].c_str())));
+				fields.push_back(TFWField("Rarity", TFWInteger(i % 5)));
+				fields.push_back(TFWField("Icon", TFWString(text[2].c_str())));
+			}
+			for (int64_t i = 0; i < count; i++)
+			{
+				rows.push_back({ names[i].c_str(), &fields[i * FieldCount], FieldCount });
+			}
+		}
+	};
+
+	auto NativeRowsBenchmark(benchmark::State& state) -> void
+	{
+		Workbench& workbench = Workbench::Get();
+		workbench.SetBuildThreads(state.range(1));
+		NativeFlatRows rows(state.range(0));
+		int32_t table = TFWWorkbench_FindTable("Flat");
+
+		for (auto _ : state)
+		{
+			TFWWorkbench_WriteRows(table, rows.rows.data(), rows.rows.size(), TFW_WRITE_REPLACE);
+			workbench.Update();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Copies of ready-made rows, taken from the rows the Lua path wrote
+	auto NativeRowImagesBenchmark(benchmark::State& state) -> void
+	{
+		Workbench& workbench = Workbench::Get();
+		workbench.MakeRows("Flat", state.range(0));
+		workbench.AddRows("Flat");
+
+		UDataTable* flatTable = workbench.FlatTable();
+		UScriptStruct* rowStruct = flatTable->GetRowStruct();
+		size_t rowSize = static_cast<size_t>(rowStruct->GetStructureSize());
+		std::vector<std::string> names;
+		std::vector<const char*> namePointers;
+		std::vector<uint8> images(rowSize * state.range(0));
+		for (int64_t i = 0; i < state.range(0); i++)
+		{
+			names.push_back("Row_" + std::to_string(i + 1));
+			uint8* image = images.data() + i * rowSize;
+			rowStruct->InitializeStruct(image);
+			rowStruct->CopyScriptStruct(image, flatTable->FindRowUnchecked(FName(to_wstring(names.back()))));
+		}
+		for (const std::string& name : names) namePointers.push_back(name.c_str());
+		int32_t table = TFWWorkbench_FindTable("Flat");
+
+		for (auto _ : state)
+		{
+			TFWWorkbench_AddRowImages(table, rowStruct, namePointers.data(), images.data(), rowSize, namePointers.size());
+			workbench.Update();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+
+		for (int64_t i = 0; i < state.range(0); i++)
+		{
+			rowStruct->DestroyStruct(images.data() + i * rowSize);
+		}
+	}
+
+	// Resolves `tables` configured tables among `objects` other objects. The tables are loaded
+	// anew before each iteration, so every iteration is the first use after a sweep was due.
+	auto ResolveBenchmark(benchmark::State& state) -> void
+	{
+		Workbench& workbench = Workbench::Get();
+		UScriptStruct* rowStruct = workbench.FlatTable()->GetRowStruct();
+		size_t rowSize = static_cast<size_t>(rowStruct->GetStructureSize());
+
+		std::vector<std::unique_ptr<UObject>> objects;
+		for (int64_t i = 0; i < state.range(0); i++)
+		{
+			std::wstring name = STR("Object_") + std::to_wstring(i);
+			objects.push_back(std::make_unique<UObject>(STR("/Game/Bench/Objects/") + name + STR(".") + name));
+		}
+
+		std::vector<std::wstring> paths;
+		std::vector<int32_t> handles;
+		for (int64_t i = 0; i < state.range(1); i++)
+		{
+			std::string name = "DT_Resolve_" + std::to_string(i);
+			paths.push_back(to_wstring("/Game/Bench/Resolve/" + name + "." + name));
+			handles.push_back(TFWWorkbench_ConfigureTable(name.c_str(), to_string(paths.back()).c_str()));
+		}
+
+		std::vector<std::unique_ptr<UDataTable>> tables(paths.size());
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			for (size_t i = 0; i < paths.size(); i++)
+			{
+				tables[i].reset();
+				tables[i] = std::make_unique<UDataTable>(paths[i], rowStruct);
+			}
+			state.ResumeTiming();
+
+			for (int32_t handle : handles)
+			{
+				TFWWorkbench_AddRowImages(handle, nullptr, nullptr, nullptr, rowSize, 0);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(1));
+	}
+
+	// Writes `count` flat rows as a JSON import file
+	auto WriteFlatRowFile(const std::filesystem::path& path, int64_t count) -> void
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << "{\n";
+		for (int64_t i = 1; i <= count; i++)
+		{
+			file << "\"Row_" << i << "\": {"
+				<< "\"Damage\": " << i % 200 << ", "
+				<< "\"Weight\": " << i * 0.25 << ", "
+				<< "\"Stackable\": " << (i % 2 == 0 ? "true" : "false") << ", "
+				<< "\"Price\": " << i * 1.5 << ", "
+				<< "\"Category\": \"Category_" << i % 16 << "\", "
+				<< "\"Description\": \"Item description " << i << "\", "
+				<< "\"Rarity\": " << i % 5 << ", "
+				<< "\"Icon\": \"/Game/UI/Icons/T_Item_" << i << ".T_Item_" << i << "\"}"
+				<< (i < count ? ",\n" : "\n");
+		}
+		file << "}\n";
+	}
+
+	auto ImportBenchmark(benchmark::State& state, bool rowCache) -> void
+	{
+		Workbench& workbench = Workbench::Get();
+		auto path = workbench.TempDir() / ("flat-" + std::to_string(state.range(0)) + ".json");
+		WriteFlatRowFile(path, state.range(0));
+
+		workbench.Configure(rowCache);
+		workbench.SetBuildThreads(state.range(1));
+		// Writes the cache file the cached runs replay
+		if (rowCache) workbench.ImportRows("Flat", path);
+
+		for (auto _ : state)
+		{
+			workbench.ImportRows("Flat", path);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+
+		workbench.Configure(false);
+	}
+}
+
+static void BM_FlatRows(benchmark::State& state) { AddRowsBenchmark(state, "Flat"); }
+static void BM_StructArrayRows(benchmark::State& state) { AddRowsBenchmark(state, "StructArray"); }
+static void BM_MapRows(benchmark::State& state) { AddRowsBenchmark(state, "Map"); }
+static void BM_TextRows(benchmark::State& state) { AddRowsBenchmark(state, "Text"); }
+static void BM_CurveRows(benchmark::State& state) { AddRowsBenchmark(state, "Curve"); }
+static void BM_CloneRows(benchmark::State& state) { CloneBenchmark(state); }
+static void BM_NativeFlatRows(benchmark::State& state) { NativeRowsBenchmark(state); }
+static void BM_NativeRowImages(benchmark::State& state) { NativeRowImagesBenchmark(state); }
+static void BM_FindRows(benchmark::State& state) { FindBenchmark(state); }
+static void BM_ReapplyRows(benchmark::State& state) { ReapplyBenchmark(state, false); }
+static void BM_ReapplyRowsIncremental(benchmark::State& state) { ReapplyBenchmark(state, true); }
+static void BM_ResolveTables(benchmark::State& state) { ResolveBenchmark(state); }
+static void BM_ImportJson(benchmark::State& state) { ImportBenchmark(state, false); }
+static void BM_ImportJsonCached(benchmark::State& state) { ImportBenchmark(state, true); }
+
+// Batch size x build workers
+static void RowArgs(benchmark::internal::Benchmark* benchmark)
+{
+	benchmark->ArgNames({ "rows", "workers" });
+	benchmark->ArgsProduct({ { 64, 512, 4096 }, { 0, 4 } });
+}
+
+BENCHMARK(BM_FlatRows)->Apply(RowArgs);
+BENCHMARK(BM_StructArrayRows)->Apply(RowArgs);
+BENCHMARK(BM_MapRows)->Apply(RowArgs);
+BENCHMARK(BM_TextRows)->Apply(RowArgs);
+BENCHMARK(BM_CurveRows)->Apply(RowArgs);
+BENCHMARK(BM_CloneRows)->Apply(RowArgs);
+BENCHMARK(BM_NativeFlatRows)->Apply(RowArgs);
+BENCHMARK(BM_NativeRowImages)->ArgNames({ "rows" })->Arg(4096);
+BENCHMARK(BM_FindRows)->ArgName("rows")->Arg(4096);
+BENCHMARK(BM_ReapplyRows)->ArgNames({ "rows", "workers" })->ArgsProduct({ { 3072 }, { 0, 4 } });
+BENCHMARK(BM_ReapplyRowsIncremental)->ArgNames({ "rows", "workers" })->ArgsProduct({ { 3072 }, { 0, 4 } });
+BENCHMARK(BM_ResolveTables)->ArgNames({ "objects", "tables" })->ArgsProduct({ { 100000 }, { 1, 24 } });
+BENCHMARK(BM_ImportJson)->ArgNames({ "rows", "workers" })->ArgsProduct({ { 4096 }, { 0, 4 } });
+BENCHMARK(BM_ImportJsonCached)->ArgNames({ "rows", "workers" })->ArgsProduct({ { 4096 }, { 0, 4 } });
+
+BENCHMARK_MAIN();
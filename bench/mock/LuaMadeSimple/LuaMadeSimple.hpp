@@ -0,0 +1,164 @@
+#pragma once
+
+// Stand-in for the LuaMadeSimple wrapper UE4SS passes to on_lua_start, over a real Lua 5.4 state.
+// As in UE4SS, the is_* checks look at a stack index (1 by default) and the get_* accessors
+// remove the value they return from the stack.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <lua.hpp>
+
+namespace RC::LuaMadeSimple
+{
+	class Lua;
+
+	// A key or value copied out of a table during for_each_in_table
+	class LuaTableData
+	{
+	private:
+		int m_type = LUA_TNIL;
+		bool m_is_integer = false;
+		std::string m_string = {};
+		lua_Integer m_integer = 0;
+		lua_Number m_number = 0.0;
+		bool m_bool = false;
+
+	public:
+		LuaTableData(lua_State* L, int index) : m_type(lua_type(L, index))
+		{
+			switch (m_type)
+			{
+			case LUA_TSTRING:
+			{
+				size_t size = 0;
+				const char* data = lua_tolstring(L, index, &size);
+				m_string.assign(data, size);
+				break;
+			}
+			case LUA_TNUMBER:
+				m_is_integer = lua_isinteger(L, index);
+				m_integer = lua_tointeger(L, index);
+				m_number = lua_tonumber(L, index);
+				break;
+			case LUA_TBOOLEAN:
+				m_bool = lua_toboolean(L, index);
+				break;
+			}
+		}
+
+		auto is_nil() const -> bool { return m_type == LUA_TNIL; }
+		auto is_string() const -> bool { return m_type == LUA_TSTRING; }
+		auto is_number() const -> bool { return m_type == LUA_TNUMBER; }
+		auto is_integer() const -> bool { return m_type == LUA_TNUMBER && m_is_integer; }
+		auto is_bool() const -> bool { return m_type == LUA_TBOOLEAN; }
+		auto is_table() const -> bool { return m_type == LUA_TTABLE; }
+
+		auto get_string() const -> std::string_view { return m_string; }
+		auto get_integer() const -> int64_t { return m_integer; }
+		auto get_number() const -> double { return m_number; }
+		auto get_bool() const -> bool { return m_bool; }
+	};
+
+	struct LuaTableReference
+	{
+		LuaTableData& key;
+		LuaTableData& value;
+	};
+
+	class Lua
+	{
+	public:
+		using LuaFunction = int (*)(const Lua&);
+
+	private:
+		lua_State* m_lua_state;
+
+	public:
+		explicit Lua(lua_State* L) : m_lua_state(L) {}
+
+		auto get_lua_state() const -> lua_State* { return m_lua_state; }
+
+		// Binds `function` to a global, with the function pointer kept in an upvalue
+		auto register_function(const std::string& name, LuaFunction function) const -> void
+		{
+			auto* storage = static_cast<LuaFunction*>(lua_newuserdatauv(m_lua_state, sizeof(LuaFunction), 0));
+			*storage = function;
+			lua_pushcclosure(m_lua_state, &Lua::Dispatch, 1);
+			lua_setglobal(m_lua_state, name.c_str());
+		}
+
+		auto is_nil(int index = 1) const -> bool { return lua_type(m_lua_state, index) == LUA_TNIL; }
+		auto is_string(int index = 1) const -> bool { return lua_type(m_lua_state, index) == LUA_TSTRING; }
+		auto is_number(int index = 1) const -> bool { return lua_type(m_lua_state, index) == LUA_TNUMBER; }
+		auto is_integer(int index = 1) const -> bool { return lua_type(m_lua_state, index) == LUA_TNUMBER && lua_isinteger(m_lua_state, index); }
+		auto is_bool(int index = 1) const -> bool { return lua_type(m_lua_state, index) == LUA_TBOOLEAN; }
+		auto is_table(int index = 1) const -> bool { return lua_type(m_lua_state, index) == LUA_TTABLE; }
+
+		// The returned view stays valid while the string is referenced from Lua, as it is in UE4SS
+		auto get_string(int index = 1) const -> std::string_view
+		{
+			size_t size = 0;
+			const char* data = lua_tolstring(m_lua_state, index, &size);
+			std::string_view value(data ? data : "", size);
+			lua_remove(m_lua_state, index);
+			return value;
+		}
+
+		auto get_integer(int index = 1) const -> int64_t
+		{
+			lua_Integer value = lua_tointeger(m_lua_state, index);
+			lua_remove(m_lua_state, index);
+			return value;
+		}
+
+		auto get_number(int index = 1) const -> double
+		{
+			lua_Number value = lua_tonumber(m_lua_state, index);
+			lua_remove(m_lua_state, index);
+			return value;
+		}
+
+		auto get_bool(int index = 1) const -> bool
+		{
+			bool value = lua_toboolean(m_lua_state, index);
+			lua_remove(m_lua_state, index);
+			return value;
+		}
+
+		auto set_nil() const -> void { lua_pushnil(m_lua_state); }
+		auto set_bool(bool value) const -> void { lua_pushboolean(m_lua_state, value); }
+		auto set_integer(int64_t value) const -> void { lua_pushinteger(m_lua_state, value); }
+		auto set_number(double value) const -> void { lua_pushnumber(m_lua_state, value); }
+		auto set_string(std::string_view value) const -> void { lua_pushlstring(m_lua_state, value.data(), value.size()); }
+
+		// Calls `callable` with every pair of the table at the top of the stack until it returns true
+		template<typename Callable>
+		auto for_each_in_table(Callable callable) const -> void
+		{
+			int table = lua_absindex(m_lua_state, -1);
+			lua_pushnil(m_lua_state);
+			while (lua_next(m_lua_state, table) != 0)
+			{
+				LuaTableData key(m_lua_state, -2);
+				LuaTableData value(m_lua_state, -1);
+				lua_pop(m_lua_state, 1);
+				if (callable(LuaTableReference{ key, value }))
+				{
+					lua_pop(m_lua_state, 1);
+					break;
+				}
+			}
+		}
+
+	private:
+		static auto Dispatch(lua_State* L) -> int
+		{
+			auto function = *static_cast<LuaFunction*>(lua_touserdata(L, lua_upvalueindex(1)));
+			Lua lua(L);
+			return function(lua);
+		}
+	};
+}
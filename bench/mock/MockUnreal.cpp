@@ -0,0 +1,810 @@
+#include "MockUnreal.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <mutex>
+
+namespace RC
+{
+	auto to_wstring(std::string_view value) -> StringType
+	{
+		StringType result;
+		result.reserve(value.size());
+		for (size_t i = 0; i < value.size();)
+		{
+			auto c = static_cast<unsigned char>(value[i]);
+			uint32_t codepoint = c;
+			size_t extra = 0;
+			if (c >= 0xF0) { codepoint = c & 0x07; extra = 3; }
+			else if (c >= 0xE0) { codepoint = c & 0x0F; extra = 2; }
+			else if (c >= 0xC0) { codepoint = c & 0x1F; extra = 1; }
+
+			i++;
+			for (size_t j = 0; j < extra && i < value.size(); j++, i++)
+			{
+				codepoint = (codepoint << 6) | (static_cast<unsigned char>(value[i]) & 0x3F);
+			}
+			result.push_back(static_cast<CharType>(codepoint));
+		}
+		return result;
+	}
+
+	auto to_string(StringViewType value) -> std::string
+	{
+		std::string result;
+		result.reserve(value.size());
+		for (CharType c : value)
+		{
+			auto codepoint = static_cast<uint32_t>(c);
+			if (codepoint < 0x80)
+			{
+				result.push_back(static_cast<char>(codepoint));
+			}
+			else if (codepoint < 0x800)
+			{
+				result.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+				result.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+			}
+			else if (codepoint < 0x10000)
+			{
+				result.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+				result.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+				result.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+			}
+			else
+			{
+				result.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+				result.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+				result.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+				result.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+			}
+		}
+		return result;
+	}
+
+	namespace Output
+	{
+		auto IsEnabled(LogLevel::LogLevel level) -> bool
+		{
+			static const bool verbose = std::getenv("TFWBENCH_LOG") != nullptr;
+			return verbose || level == LogLevel::Warning || level == LogLevel::Error;
+		}
+
+		auto Write(LogLevel::LogLevel level, StringViewType message) -> void
+		{
+			std::string text = to_string(message);
+			std::fwrite(text.data(), 1, text.size(), level >= LogLevel::Warning ? stderr : stdout);
+		}
+	}
+}
+
+namespace RC::Unreal
+{
+	namespace
+	{
+		auto Align(int32 value, int32 alignment) -> int32
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		// Global name table, index 0 is None
+		struct FNameTable
+		{
+			std::mutex mutex;
+			std::vector<StringType> names{ STR("None") };
+			std::unordered_map<StringType, uint32> indices{ { STR("None"), 0 } };
+		};
+
+		auto GetNameTable() -> FNameTable&
+		{
+			static FNameTable table;
+			return table;
+		}
+
+		struct FObjectRegistry
+		{
+			std::mutex mutex;
+			std::unordered_map<StringType, UObject*> objects;
+			std::vector<UObject*> order;
+			std::vector<FUObjectDeleteListener*> listeners;
+			std::vector<Hook::StaticConstructObjectPostCallback> constructCallbacks;
+		};
+
+		auto GetObjectRegistry() -> FObjectRegistry&
+		{
+			static FObjectRegistry registry;
+			return registry;
+		}
+
+		// Strips the quotes around an exported object path, e.g. Class'/Game/Path.Path'
+		auto ParseObjectPath(const CharType* buffer) -> StringType
+		{
+			StringViewType text(buffer);
+			if (size_t open = text.find(STR('\'')); open != StringViewType::npos)
+			{
+				size_t close = text.rfind(STR('\''));
+				if (close > open) return StringType(text.substr(open + 1, close - open - 1));
+			}
+			if (text.size() >= 2 && text.front() == STR('"') && text.back() == STR('"'))
+			{
+				return StringType(text.substr(1, text.size() - 2));
+			}
+			return StringType(text);
+		}
+
+		// Reads a quoted argument of NSLOCTEXT/LOCTABLE, advancing `cursor` past it
+		auto ReadQuoted(StringViewType& cursor, StringType& out) -> bool
+		{
+			size_t open = cursor.find(STR('"'));
+			if (open == StringViewType::npos) return false;
+
+			out.clear();
+			for (size_t i = open + 1; i < cursor.size(); i++)
+			{
+				if (cursor[i] == STR('\\') && i + 1 < cursor.size())
+				{
+					out.push_back(cursor[++i]);
+				}
+				else if (cursor[i] == STR('"'))
+				{
+					cursor.remove_prefix(i + 1);
+					return true;
+				}
+				else
+				{
+					out.push_back(cursor[i]);
+				}
+			}
+			return false;
+		}
+	}
+
+	auto FMemory::Malloc(size_t count, uint32 alignment) -> void*
+	{
+		size_t align = std::max<size_t>(alignment, alignof(std::max_align_t));
+		size_t size = (std::max<size_t>(count, 1) + align - 1) / align * align;
+		return std::aligned_alloc(align, size);
+	}
+
+	auto FMemory::Free(void* original) -> void
+	{
+		std::free(original);
+	}
+
+	FName::FName(StringViewType name, EFindName findType)
+	{
+		FNameTable& table = GetNameTable();
+		std::lock_guard lock(table.mutex);
+
+		StringType key(name);
+		if (auto it = table.indices.find(key); it != table.indices.end())
+		{
+			m_comparison_index = it->second;
+			return;
+		}
+		if (findType == FNAME_Find) return;
+
+		m_comparison_index = static_cast<uint32>(table.names.size());
+		table.names.push_back(key);
+		table.indices.emplace(std::move(key), m_comparison_index);
+	}
+
+	auto FName::ToString() const -> StringType
+	{
+		FNameTable& table = GetNameTable();
+		std::lock_guard lock(table.mutex);
+		return table.names[m_comparison_index];
+	}
+
+	FString::FString(const CharType* value) : FString(StringViewType(value ? value : STR(""))) {}
+
+	FString::FString(StringViewType value)
+	{
+		if (value.empty()) return;
+
+		m_num = static_cast<int32>(value.size());
+		m_data = new CharType[value.size() + 1];
+		std::wmemcpy(m_data, value.data(), value.size());
+		m_data[value.size()] = STR('\0');
+	}
+
+	auto FString::operator=(const FString& other) -> FString&
+	{
+		if (this != &other) *this = FString(other);
+		return *this;
+	}
+
+	auto FString::operator=(FString&& other) noexcept -> FString&
+	{
+		if (this != &other)
+		{
+			delete[] m_data;
+			m_data = std::exchange(other.m_data, nullptr);
+			m_num = std::exchange(other.m_num, 0);
+		}
+		return *this;
+	}
+
+	auto FText::operator=(const FText& other) -> FText&
+	{
+		if (m_data != other.m_data)
+		{
+			Release();
+			m_data = other.m_data;
+			if (m_data) m_data->refs++;
+		}
+		return *this;
+	}
+
+	auto FText::operator=(FText&& other) noexcept -> FText&
+	{
+		if (this != &other)
+		{
+			Release();
+			m_data = std::exchange(other.m_data, nullptr);
+		}
+		return *this;
+	}
+
+	auto FText::Release() -> void
+	{
+		if (m_data && --m_data->refs == 0) delete m_data;
+		m_data = nullptr;
+	}
+
+	auto FScriptArray::Reallocate(int32 max, int32 elementSize, uint32 alignment) -> void
+	{
+		void* data = max > 0 ? FMemory::Malloc(static_cast<size_t>(max) * elementSize, alignment) : nullptr;
+		if (m_data && data) std::memcpy(data, m_data, static_cast<size_t>(m_num) * elementSize);
+		FMemory::Free(m_data);
+		m_data = data;
+		m_max = max;
+	}
+
+	auto FScriptArray::Empty(int32 slack, int32 elementSize, uint32 alignment) -> void
+	{
+		m_num = 0;
+		if (slack != m_max) Reallocate(slack, elementSize, alignment);
+	}
+
+	auto FScriptArray::Add(int32 count, int32 elementSize, uint32 alignment) -> int32
+	{
+		int32 index = m_num;
+		if (m_num + count > m_max)
+		{
+			Reallocate(std::max(m_num + count, m_max * 2), elementSize, alignment);
+		}
+		m_num += count;
+		return index;
+	}
+
+	auto FScriptArray::AddZeroed(int32 count, int32 elementSize, uint32 alignment) -> int32
+	{
+		int32 index = Add(count, elementSize, alignment);
+		std::memset(static_cast<uint8*>(m_data) + static_cast<size_t>(index) * elementSize, 0, static_cast<size_t>(count) * elementSize);
+		return index;
+	}
+
+	FScriptMap::~FScriptMap()
+	{
+		FMemory::Free(m_data);
+		delete[] m_hash;
+	}
+
+	auto FScriptMap::GetScriptLayout(int32 keySize, int32 keyAlignment, int32 valueSize, int32 valueAlignment) -> FScriptMapLayout
+	{
+		FScriptMapLayout layout{};
+		layout.ValueOffset = Align(keySize, valueAlignment);
+
+		int32 pairAlignment = std::max({ keyAlignment, valueAlignment, static_cast<int32>(alignof(int32)) });
+		int32 pairSize = layout.ValueOffset + valueSize;
+		layout.SetLayout.HashNextIdOffset = Align(pairSize, alignof(int32));
+		layout.SetLayout.HashIndexOffset = layout.SetLayout.HashNextIdOffset + sizeof(int32);
+		layout.SetLayout.Size = Align(layout.SetLayout.HashIndexOffset + sizeof(int32), pairAlignment);
+		return layout;
+	}
+
+	auto FScriptMap::Empty(int32 slack, const FScriptMapLayout& layout) -> void
+	{
+		m_num = 0;
+		delete[] m_hash;
+		m_hash = nullptr;
+		m_hash_size = 0;
+
+		if (slack != m_max)
+		{
+			FMemory::Free(m_data);
+			m_data = slack > 0 ? static_cast<uint8*>(FMemory::Malloc(static_cast<size_t>(slack) * layout.SetLayout.Size, 16)) : nullptr;
+			m_max = slack;
+		}
+	}
+
+	auto FScriptMap::AddUninitialized(const FScriptMapLayout& layout) -> int32
+	{
+		if (m_num == m_max)
+		{
+			int32 max = std::max(4, m_max * 2);
+			auto* data = static_cast<uint8*>(FMemory::Malloc(static_cast<size_t>(max) * layout.SetLayout.Size, 16));
+			if (m_data) std::memcpy(data, m_data, static_cast<size_t>(m_num) * layout.SetLayout.Size);
+			FMemory::Free(m_data);
+			m_data = data;
+			m_max = max;
+		}
+		return m_num++;
+	}
+
+	auto FScriptMap::Rehash(const FScriptMapLayout& layout, const std::function<uint32(const void*)>& getKeyHash) -> void
+	{
+		delete[] m_hash;
+		m_hash_size = 1;
+		while (m_hash_size < m_num) m_hash_size <<= 1;
+		m_hash = new int32[m_hash_size];
+		std::fill_n(m_hash, m_hash_size, -1);
+
+		for (int32 i = 0; i < m_num; i++)
+		{
+			uint8* pair = m_data + static_cast<size_t>(i) * layout.SetLayout.Size;
+			int32 bucket = static_cast<int32>(getKeyHash(pair) & (m_hash_size - 1));
+			*reinterpret_cast<int32*>(pair + layout.SetLayout.HashIndexOffset) = bucket;
+			*reinterpret_cast<int32*>(pair + layout.SetLayout.HashNextIdOffset) = m_hash[bucket];
+			m_hash[bucket] = i;
+		}
+	}
+
+	auto FScriptMap::FindPairIndex(const void* key,
+		const FScriptMapLayout& layout,
+		const std::function<uint32(const void*)>& getKeyHash,
+		const std::function<bool(const void*, const void*)>& keyEquality) const -> int32
+	{
+		if (!m_hash) return -1;
+
+		int32 bucket = static_cast<int32>(getKeyHash(key) & (m_hash_size - 1));
+		for (int32 i = m_hash[bucket]; i != -1;)
+		{
+			const uint8* pair = m_data + static_cast<size_t>(i) * layout.SetLayout.Size;
+			if (keyEquality(key, pair)) return i;
+			i = *reinterpret_cast<const int32*>(pair + layout.SetLayout.HashNextIdOffset);
+		}
+		return -1;
+	}
+
+	auto FProperty::GetValueTypeHash(const void* src) const -> uint32
+	{
+		uint32 hash = 2166136261u;
+		for (int32 i = 0; i < m_element_size; i++)
+		{
+			hash = (hash ^ static_cast<const uint8*>(src)[i]) * 16777619u;
+		}
+		return hash;
+	}
+
+	auto FProperty::ImportText_Direct(const CharType*, void*, UObject*, int32, FOutputDevice*) const -> const CharType*
+	{
+		return nullptr;
+	}
+
+	auto FProperty::ExportTextItem(FString& valueStr, const void*, const void*, UObject*, int32, UObject*) const -> void
+	{
+		valueStr = FString();
+	}
+
+	auto FBoolProperty::ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType*
+	{
+		StringViewType text(buffer);
+		if (text == STR("True") || text == STR("true") || text == STR("1")) SetPropertyValue(data, true);
+		else if (text == STR("False") || text == STR("false") || text == STR("0")) SetPropertyValue(data, false);
+		else return nullptr;
+		return buffer + text.size();
+	}
+
+	auto FBoolProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		valueStr = FString(GetPropertyValue(propertyValue) ? STR("True") : STR("False"));
+	}
+
+	auto FStrProperty::GetValueTypeHash(const void* src) const -> uint32
+	{
+		return static_cast<uint32>(std::hash<StringViewType>{}(**static_cast<const FString*>(src)));
+	}
+
+	auto FStrProperty::ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType*
+	{
+		*static_cast<FString*>(data) = FString(buffer);
+		return buffer + std::wcslen(buffer);
+	}
+
+	auto FStrProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		valueStr = *static_cast<const FString*>(propertyValue);
+	}
+
+	auto FNameProperty::GetValueTypeHash(const void* src) const -> uint32
+	{
+		return static_cast<uint32>(FNameHash{}(*static_cast<const FName*>(src)));
+	}
+
+	auto FNameProperty::ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType*
+	{
+		*static_cast<FName*>(data) = FName(buffer);
+		return buffer + std::wcslen(buffer);
+	}
+
+	auto FNameProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		valueStr = FString(static_cast<const FName*>(propertyValue)->ToString());
+	}
+
+	auto FTextProperty::ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType*
+	{
+		StringViewType text(buffer);
+		auto* value = static_cast<FText*>(data);
+
+		if (text.starts_with(STR("NSLOCTEXT(")))
+		{
+			StringType textNamespace, key, source;
+			if (!ReadQuoted(text, textNamespace) || !ReadQuoted(text, key) || !ReadQuoted(text, source)) return nullptr;
+			*value = FText(source);
+		}
+		else if (text.starts_with(STR("LOCTABLE(")))
+		{
+			StringType table, key;
+			if (!ReadQuoted(text, table) || !ReadQuoted(text, key)) return nullptr;
+			*value = FText(table + STR(":") + key);
+		}
+		else
+		{
+			*value = FText(text);
+		}
+		return buffer + std::wcslen(buffer);
+	}
+
+	auto FTextProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		valueStr = FString(static_cast<const FText*>(propertyValue)->ToString());
+	}
+
+	auto FObjectProperty::ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType*
+	{
+		StringType path = ParseObjectPath(buffer);
+		*static_cast<UObject**>(data) = path == STR("None") ? nullptr : UObjectGlobals::FindObjectByPath(path);
+		return buffer + std::wcslen(buffer);
+	}
+
+	auto FObjectProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		UObject* object = *static_cast<UObject* const*>(propertyValue);
+		valueStr = FString(object ? object->GetPathName() : StringType(STR("None")));
+	}
+
+	auto FSoftObjectProperty::ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType*
+	{
+		static_cast<FSoftObjectPtr*>(data)->AssetPath = FString(ParseObjectPath(buffer));
+		return buffer + std::wcslen(buffer);
+	}
+
+	auto FSoftObjectProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		valueStr = static_cast<const FSoftObjectPtr*>(propertyValue)->AssetPath;
+	}
+
+	FStructProperty::FStructProperty(StringViewType name, UScriptStruct* scriptStruct)
+		: FProperty(name, scriptStruct->GetStructureSize(), scriptStruct->GetMinAlignment()), m_struct(scriptStruct)
+	{
+	}
+
+	auto FStructProperty::InitializeValue(void* dest) const -> void
+	{
+		m_struct->InitializeStruct(dest);
+	}
+
+	auto FStructProperty::DestroyValue(void* dest) const -> void
+	{
+		m_struct->DestroyStruct(dest);
+	}
+
+	auto FStructProperty::CopyCompleteValue(void* dest, const void* src) const -> void
+	{
+		m_struct->CopyScriptStruct(dest, src);
+	}
+
+	auto FStructProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		StringType text = STR("(");
+		for (FProperty* property : m_struct->ForEachPropertyInChain())
+		{
+			FString field;
+			property->ExportTextItem(field, static_cast<const uint8*>(propertyValue) + property->GetOffset_Internal(), nullptr, nullptr, PPF_None);
+			if (text.size() > 1) text += STR(",");
+			text += property->GetName() + STR("=") + *field;
+		}
+		valueStr = FString(text + STR(")"));
+	}
+
+	auto FArrayProperty::DestroyValue(void* dest) const -> void
+	{
+		auto* array = static_cast<FScriptArray*>(dest);
+		auto* data = static_cast<uint8*>(array->GetData());
+		for (int32 i = 0; i < array->Num(); i++)
+		{
+			m_inner->DestroyValue(data + static_cast<size_t>(i) * m_inner->GetSize());
+		}
+		array->~FScriptArray();
+	}
+
+	auto FArrayProperty::CopyCompleteValue(void* dest, const void* src) const -> void
+	{
+		if (dest == src) return;
+
+		DestroyValue(dest);
+		InitializeValue(dest);
+
+		auto* destArray = static_cast<FScriptArray*>(dest);
+		const auto* srcArray = static_cast<const FScriptArray*>(src);
+		int32 elementSize = m_inner->GetSize();
+		destArray->Add(srcArray->Num(), elementSize, m_inner->GetMinAlignment());
+
+		auto* destData = static_cast<uint8*>(destArray->GetData());
+		const auto* srcData = static_cast<const uint8*>(srcArray->GetData());
+		for (int32 i = 0; i < srcArray->Num(); i++)
+		{
+			m_inner->InitializeValue(destData + static_cast<size_t>(i) * elementSize);
+			m_inner->CopyCompleteValue(destData + static_cast<size_t>(i) * elementSize, srcData + static_cast<size_t>(i) * elementSize);
+		}
+	}
+
+	auto FArrayProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		const auto* array = static_cast<const FScriptArray*>(propertyValue);
+		const auto* data = static_cast<const uint8*>(array->GetData());
+
+		StringType text = STR("(");
+		for (int32 i = 0; i < array->Num(); i++)
+		{
+			FString element;
+			m_inner->ExportTextItem(element, data + static_cast<size_t>(i) * m_inner->GetSize(), nullptr, nullptr, PPF_None);
+			if (i > 0) text += STR(",");
+			text += *element;
+		}
+		valueStr = FString(text + STR(")"));
+	}
+
+	auto FMapProperty::GetLayout() const -> FScriptMapLayout
+	{
+		return FScriptMap::GetScriptLayout(m_key->GetSize(), m_key->GetMinAlignment(), m_value->GetSize(), m_value->GetMinAlignment());
+	}
+
+	auto FMapProperty::DestroyValue(void* dest) const -> void
+	{
+		auto* map = static_cast<FScriptMap*>(dest);
+		FScriptMapLayout layout = GetLayout();
+		for (int32 i = 0; i < map->GetMaxIndex(); i++)
+		{
+			auto* pair = static_cast<uint8*>(map->GetData(i, layout));
+			m_key->DestroyValue(pair);
+			m_value->DestroyValue(pair + layout.ValueOffset);
+		}
+		map->~FScriptMap();
+	}
+
+	auto FMapProperty::CopyCompleteValue(void* dest, const void* src) const -> void
+	{
+		if (dest == src) return;
+
+		DestroyValue(dest);
+		InitializeValue(dest);
+
+		auto* destMap = static_cast<FScriptMap*>(dest);
+		const auto* srcMap = static_cast<const FScriptMap*>(src);
+		FScriptMapLayout layout = GetLayout();
+		destMap->Empty(srcMap->Num(), layout);
+		for (int32 i = 0; i < srcMap->GetMaxIndex(); i++)
+		{
+			const auto* srcPair = static_cast<const uint8*>(srcMap->GetData(i, layout));
+			auto* destPair = static_cast<uint8*>(destMap->GetData(destMap->AddUninitialized(layout), layout));
+			m_key->InitializeValue(destPair);
+			m_key->CopyCompleteValue(destPair, srcPair);
+			m_value->InitializeValue(destPair + layout.ValueOffset);
+			m_value->CopyCompleteValue(destPair + layout.ValueOffset, srcPair + layout.ValueOffset);
+		}
+		destMap->Rehash(layout, [this](const void* key) { return m_key->GetValueTypeHash(key); });
+	}
+
+	auto FMapProperty::ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void
+	{
+		const auto* map = static_cast<const FScriptMap*>(propertyValue);
+		FScriptMapLayout layout = GetLayout();
+
+		StringType text = STR("(");
+		for (int32 i = 0; i < map->GetMaxIndex(); i++)
+		{
+			const auto* pair = static_cast<const uint8*>(map->GetData(i, layout));
+			FString key, value;
+			m_key->ExportTextItem(key, pair, nullptr, nullptr, PPF_None);
+			m_value->ExportTextItem(value, pair + layout.ValueOffset, nullptr, nullptr, PPF_None);
+			if (i > 0) text += STR(",");
+			text += STR("(") + StringType(*key) + STR(", ") + *value + STR(")");
+		}
+		valueStr = FString(text + STR(")"));
+	}
+
+	UObject::UObject(StringViewType path) : m_path(path), m_name(GetName())
+	{
+		FObjectRegistry& registry = GetObjectRegistry();
+		std::lock_guard lock(registry.mutex);
+		registry.objects[m_path] = this;
+		registry.order.push_back(this);
+	}
+
+	UObject::~UObject()
+	{
+		FObjectRegistry& registry = GetObjectRegistry();
+		std::vector<FUObjectDeleteListener*> listeners;
+		{
+			std::lock_guard lock(registry.mutex);
+			if (auto it = registry.objects.find(m_path); it != registry.objects.end() && it->second == this)
+			{
+				registry.objects.erase(it);
+			}
+			std::erase(registry.order, this);
+			listeners = registry.listeners;
+		}
+
+		for (FUObjectDeleteListener* listener : listeners)
+		{
+			listener->NotifyUObjectDeleted(this, 0);
+		}
+	}
+
+	auto UObject::GetName() const -> StringType
+	{
+		size_t separator = m_path.find_last_of(STR("./:"));
+		return separator == StringType::npos ? m_path : m_path.substr(separator + 1);
+	}
+
+	auto UScriptStruct::AddProperty(std::unique_ptr<FProperty> property) -> void
+	{
+		int32 offset = Align(m_size, property->GetMinAlignment());
+		property->SetOffset_Internal(offset);
+		m_size = offset + property->GetSize();
+		m_alignment = std::max(m_alignment, property->GetMinAlignment());
+		m_properties.push_back(std::move(property));
+	}
+
+	auto UScriptStruct::ForEachPropertyInChain() const -> std::vector<FProperty*>
+	{
+		std::vector<FProperty*> properties;
+		properties.reserve(m_properties.size());
+		for (const auto& property : m_properties) properties.push_back(property.get());
+		return properties;
+	}
+
+	auto UScriptStruct::InitializeStruct(void* dest, int32 arrayDim) const -> void
+	{
+		int32 size = GetStructureSize();
+		for (int32 i = 0; i < arrayDim; i++)
+		{
+			auto* data = static_cast<uint8*>(dest) + static_cast<size_t>(i) * size;
+			std::memset(data, 0, size);
+			for (const auto& property : m_properties)
+			{
+				property->InitializeValue(data + property->GetOffset_Internal());
+			}
+		}
+	}
+
+	auto UScriptStruct::DestroyStruct(void* dest, int32 arrayDim) const -> void
+	{
+		int32 size = GetStructureSize();
+		for (int32 i = 0; i < arrayDim; i++)
+		{
+			auto* data = static_cast<uint8*>(dest) + static_cast<size_t>(i) * size;
+			for (const auto& property : m_properties)
+			{
+				property->DestroyValue(data + property->GetOffset_Internal());
+			}
+		}
+	}
+
+	auto UScriptStruct::CopyScriptStruct(void* dest, const void* src, int32 arrayDim) const -> void
+	{
+		int32 size = GetStructureSize();
+		for (int32 i = 0; i < arrayDim; i++)
+		{
+			auto* destData = static_cast<uint8*>(dest) + static_cast<size_t>(i) * size;
+			const auto* srcData = static_cast<const uint8*>(src) + static_cast<size_t>(i) * size;
+			for (const auto& property : m_properties)
+			{
+				property->CopyCompleteValue(destData + property->GetOffset_Internal(), srcData + property->GetOffset_Internal());
+			}
+		}
+	}
+
+	auto UDataTable::FindRowUnchecked(FName rowName) -> uint8*
+	{
+		uint8** row = m_row_map.Find(rowName);
+		return row ? *row : nullptr;
+	}
+
+	auto UDataTable::RemoveRow(FName rowName) -> void
+	{
+		if (uint8** row = m_row_map.Find(rowName))
+		{
+			m_row_struct->DestroyStruct(*row);
+			FMemory::Free(*row);
+			m_row_map.Remove(rowName);
+		}
+	}
+
+	auto UDataTable::EmptyTable() -> void
+	{
+		for (auto& pair : m_row_map)
+		{
+			m_row_struct->DestroyStruct(pair.Value);
+			FMemory::Free(pair.Value);
+		}
+		m_row_map.Empty();
+	}
+
+	auto UObjectArray::AddUObjectDeleteListener(FUObjectDeleteListener* listener) -> void
+	{
+		FObjectRegistry& registry = GetObjectRegistry();
+		std::lock_guard lock(registry.mutex);
+		registry.listeners.push_back(listener);
+	}
+
+	auto UObjectArray::RemoveUObjectDeleteListener(FUObjectDeleteListener* listener) -> void
+	{
+		FObjectRegistry& registry = GetObjectRegistry();
+		std::lock_guard lock(registry.mutex);
+		std::erase(registry.listeners, listener);
+	}
+
+	auto UObjectGlobals::FindObjectByPath(StringViewType path) -> UObject*
+	{
+		FObjectRegistry& registry = GetObjectRegistry();
+		std::lock_guard lock(registry.mutex);
+		auto it = registry.objects.find(StringType(path));
+		return it != registry.objects.end() ? it->second : nullptr;
+	}
+
+	auto UObjectGlobals::ForEachUObject(const std::function<LoopAction(UObject*, int32, int32)>& callable) -> void
+	{
+		std::vector<UObject*> objects;
+		{
+			FObjectRegistry& registry = GetObjectRegistry();
+			std::lock_guard lock(registry.mutex);
+			objects = registry.order;
+		}
+
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			if (callable(objects[i], static_cast<int32>(i), 0) == LoopAction::Break) break;
+		}
+	}
+
+	auto Hook::RegisterStaticConstructObjectPostCallback(StaticConstructObjectPostCallback callback) -> void
+	{
+		FObjectRegistry& registry = GetObjectRegistry();
+		std::lock_guard lock(registry.mutex);
+		registry.constructCallbacks.push_back(std::move(callback));
+	}
+
+	auto Hook::RunStaticConstructObjectPostCallbacks(UObject* object) -> void
+	{
+		std::vector<StaticConstructObjectPostCallback> callbacks;
+		{
+			FObjectRegistry& registry = GetObjectRegistry();
+			std::lock_guard lock(registry.mutex);
+			callbacks = registry.constructCallbacks;
+		}
+
+		FStaticConstructObjectParameters params;
+		params.Name = object->GetNamePrivate();
+		for (const StaticConstructObjectPostCallback& callback : callbacks)
+		{
+			callback(params, object);
+		}
+	}
+}
@@ -0,0 +1,744 @@
+#pragma once
+
+// Stand-in for the parts of UE4SS and the Unreal reflection system the row writer uses, so
+// dllmain.cpp can be built and measured on Linux. Names and signatures follow UE4SS. Memory
+// layouts don't, except that every value type is bitwise relocatable like its Unreal
+// counterpart, because FScriptArray and FScriptMap move their elements with memcpy.
+//
+// Structs are described at runtime with UScriptStruct::AddProperty, and objects register
+// themselves under their path so UObjectGlobals::StaticFindObject finds them.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/xchar.h>
+
+#define STR(str) L##str
+
+namespace RC
+{
+	using CharType = wchar_t;
+	using StringType = std::wstring;
+	using StringViewType = std::wstring_view;
+
+	auto to_wstring(std::string_view value) -> StringType;
+	auto to_string(StringViewType value) -> std::string;
+
+	namespace LogLevel
+	{
+		enum LogLevel
+		{
+			Default,
+			Normal,
+			Verbose,
+			Warning,
+			Error,
+		};
+	}
+
+	enum class LoopAction
+	{
+		Continue,
+		Break,
+	};
+
+	namespace Output
+	{
+		// Warnings and errors are printed, everything else only with TFWBENCH_LOG=1 in the environment
+		auto IsEnabled(LogLevel::LogLevel level) -> bool;
+		auto Write(LogLevel::LogLevel level, StringViewType message) -> void;
+
+		template<LogLevel::LogLevel Level, typename... Args>
+		auto send(const CharType* format, Args&&... args) -> void
+		{
+			if (!IsEnabled(Level)) return;
+			Write(Level, fmt::format(fmt::runtime(StringViewType(format)), std::forward<Args>(args)...));
+		}
+	}
+}
+
+namespace RC::Unreal
+{
+	using int8 = std::int8_t;
+	using int16 = std::int16_t;
+	using int32 = std::int32_t;
+	using int64 = std::int64_t;
+	using uint8 = std::uint8_t;
+	using uint16 = std::uint16_t;
+	using uint32 = std::uint32_t;
+	using uint64 = std::uint64_t;
+
+	enum EFindName
+	{
+		FNAME_Find,
+		FNAME_Add,
+	};
+
+	enum EPropertyPortFlags
+	{
+		PPF_None = 0,
+	};
+
+	enum EObjectFlags : int32
+	{
+		RF_NoFlags = 0,
+		RF_NeedLoad = 0x00000200,
+		RF_NeedPostLoad = 0x00001000,
+	};
+
+	class FOutputDevice;
+	class UObject;
+	class UScriptStruct;
+
+	struct FMemory
+	{
+		static auto Malloc(size_t count, uint32 alignment = 0) -> void*;
+		static auto Free(void* original) -> void;
+	};
+
+	// Index into a global name table, 0 is None
+	class FName
+	{
+	private:
+		uint32 m_comparison_index = 0;
+		uint32 m_number = 0;
+
+	public:
+		FName() = default;
+		FName(StringViewType name, EFindName findType = FNAME_Add);
+		FName(const CharType* name, EFindName findType = FNAME_Add) : FName(StringViewType(name), findType) {}
+
+		auto ToString() const -> StringType;
+		auto GetComparisonIndex() const -> uint32 { return m_comparison_index; }
+		auto GetNumber() const -> uint32 { return m_number; }
+		auto IsNone() const -> bool { return m_comparison_index == 0; }
+
+		auto operator==(const FName& other) const -> bool
+		{
+			return m_comparison_index == other.m_comparison_index && m_number == other.m_number;
+		}
+		auto operator!=(const FName& other) const -> bool { return !(*this == other); }
+	};
+
+	// Heap buffer of characters with a terminator, like TArray<TCHAR>
+	class FString
+	{
+	private:
+		CharType* m_data = nullptr;
+		int32 m_num = 0;
+
+	public:
+		FString() = default;
+		FString(const CharType* value);
+		FString(StringViewType value);
+		FString(const FString& other) : FString(StringViewType(*other)) {}
+		FString(FString&& other) noexcept : m_data(std::exchange(other.m_data, nullptr)), m_num(std::exchange(other.m_num, 0)) {}
+		~FString() { delete[] m_data; }
+
+		auto operator=(const FString& other) -> FString&;
+		auto operator=(FString&& other) noexcept -> FString&;
+
+		auto operator*() const -> const CharType* { return m_data ? m_data : STR(""); }
+		auto Len() const -> int32 { return m_num; }
+		auto IsEmpty() const -> bool { return m_num == 0; }
+	};
+
+	// Refcounted immutable text, copies share the same data
+	class FText
+	{
+	private:
+		struct FTextData
+		{
+			std::atomic<int32> refs = 1;
+			StringType string;
+		};
+		FTextData* m_data = nullptr;
+
+	public:
+		FText() = default;
+		explicit FText(StringViewType value) : m_data(new FTextData{ 1, StringType(value) }) {}
+		explicit FText(const FString& value) : FText(StringViewType(*value)) {}
+		FText(const FText& other) : m_data(other.m_data) { if (m_data) m_data->refs++; }
+		FText(FText&& other) noexcept : m_data(std::exchange(other.m_data, nullptr)) {}
+		~FText() { Release(); }
+
+		auto operator=(const FText& other) -> FText&;
+		auto operator=(FText&& other) noexcept -> FText&;
+
+		auto ToString() const -> StringType { return m_data ? m_data->string : StringType(); }
+
+	private:
+		auto Release() -> void;
+	};
+
+	// What an FSoftObjectProperty holds. Only the path is modelled.
+	struct FSoftObjectPtr
+	{
+		FString AssetPath;
+	};
+
+	class FScriptArray
+	{
+	private:
+		void* m_data = nullptr;
+		int32 m_num = 0;
+		int32 m_max = 0;
+
+	public:
+		FScriptArray() = default;
+		FScriptArray(const FScriptArray&) = delete;
+		auto operator=(const FScriptArray&) -> FScriptArray& = delete;
+		// Frees the allocation, the elements have to be destroyed by the owner first
+		~FScriptArray() { FMemory::Free(m_data); }
+
+		auto GetData() -> void* { return m_data; }
+		auto GetData() const -> const void* { return m_data; }
+		auto Num() const -> int32 { return m_num; }
+		auto Max() const -> int32 { return m_max; }
+		auto IsValidIndex(int32 index) const -> bool { return index >= 0 && index < m_num; }
+
+		// Forgets the elements without destroying them and resizes the allocation to `slack`
+		auto Empty(int32 slack, int32 elementSize, uint32 alignment) -> void;
+		auto Add(int32 count, int32 elementSize, uint32 alignment) -> int32;
+		auto AddZeroed(int32 count, int32 elementSize, uint32 alignment) -> int32;
+
+	private:
+		auto Reallocate(int32 max, int32 elementSize, uint32 alignment) -> void;
+	};
+
+	struct FScriptSetLayout
+	{
+		int32 HashNextIdOffset;
+		int32 HashIndexOffset;
+		int32 Size;
+	};
+
+	struct FScriptMapLayout
+	{
+		int32 ValueOffset;
+		FScriptSetLayout SetLayout;
+	};
+
+	// Key/value pairs stored back to back, with a hash chained through each pair's HashNextId.
+	// Pairs are never removed, so every index below GetMaxIndex is valid.
+	class FScriptMap
+	{
+	private:
+		uint8* m_data = nullptr;
+		int32 m_num = 0;
+		int32 m_max = 0;
+		int32* m_hash = nullptr;
+		int32 m_hash_size = 0;
+
+	public:
+		FScriptMap() = default;
+		FScriptMap(const FScriptMap&) = delete;
+		auto operator=(const FScriptMap&) -> FScriptMap& = delete;
+		// Frees the allocations, the pairs have to be destroyed by the owner first
+		~FScriptMap();
+
+		static auto GetScriptLayout(int32 keySize, int32 keyAlignment, int32 valueSize, int32 valueAlignment) -> FScriptMapLayout;
+
+		auto Num() const -> int32 { return m_num; }
+		auto GetMaxIndex() const -> int32 { return m_num; }
+		auto IsValidIndex(int32 index) const -> bool { return index >= 0 && index < m_num; }
+
+		auto GetData(int32 index, const FScriptMapLayout& layout) -> void* { return m_data + static_cast<size_t>(index) * layout.SetLayout.Size; }
+		auto GetData(int32 index, const FScriptMapLayout& layout) const -> const void* { return m_data + static_cast<size_t>(index) * layout.SetLayout.Size; }
+
+		// Forgets the pairs without destroying them and reserves room for `slack`
+		auto Empty(int32 slack, const FScriptMapLayout& layout) -> void;
+		// Adds a pair whose key and value the caller constructs. The hash is stale until Rehash.
+		auto AddUninitialized(const FScriptMapLayout& layout) -> int32;
+		auto Rehash(const FScriptMapLayout& layout, const std::function<uint32(const void*)>& getKeyHash) -> void;
+
+		// Index of the pair whose key matches, or -1. Requires an up to date hash.
+		auto FindPairIndex(const void* key,
+			const FScriptMapLayout& layout,
+			const std::function<uint32(const void*)>& getKeyHash,
+			const std::function<bool(const void*, const void*)>& keyEquality) const -> int32;
+	};
+
+	class FProperty
+	{
+	private:
+		StringType m_name;
+		int32 m_offset = 0;
+		int32 m_element_size = 0;
+		int32 m_alignment = 1;
+
+	public:
+		FProperty(StringViewType name, int32 elementSize, int32 alignment)
+			: m_name(name), m_element_size(elementSize), m_alignment(alignment) {}
+		virtual ~FProperty() = default;
+
+		auto GetName() const -> StringType { return m_name; }
+		auto GetOffset_Internal() const -> int32 { return m_offset; }
+		auto GetSize() const -> int32 { return m_element_size; }
+		auto GetElementSize() const -> int32 { return m_element_size; }
+		auto GetMinAlignment() const -> int32 { return m_alignment; }
+
+		// Set by UScriptStruct::AddProperty
+		auto SetOffset_Internal(int32 offset) -> void { m_offset = offset; }
+
+		template<typename T>
+		auto IsA() const -> bool { return dynamic_cast<const T*>(this) != nullptr; }
+
+		virtual auto InitializeValue(void* dest) const -> void { std::memset(dest, 0, m_element_size); }
+		virtual auto DestroyValue(void* dest) const -> void {}
+		virtual auto CopyCompleteValue(void* dest, const void* src) const -> void { std::memmove(dest, src, m_element_size); }
+		virtual auto GetValueTypeHash(const void* src) const -> uint32;
+
+		// Returns the end of the parsed text, or nullptr when it couldn't be parsed
+		virtual auto ImportText_Direct(const CharType* buffer, void* data, UObject* owner, int32 portFlags, FOutputDevice* errorText) const -> const CharType*;
+		virtual auto ExportTextItem(FString& valueStr, const void* propertyValue, const void* defaultValue, UObject* parent, int32 portFlags, UObject* exportRootScope = nullptr) const -> void;
+	};
+
+	template<typename T>
+	auto CastField(FProperty* property) -> T*
+	{
+		return dynamic_cast<T*>(property);
+	}
+
+	// A property holding a C++ value type
+	template<typename T, typename Base = FProperty>
+	class TProperty : public Base
+	{
+	public:
+		explicit TProperty(StringViewType name) : Base(name, sizeof(T), alignof(T)) {}
+
+		auto InitializeValue(void* dest) const -> void override { new (dest) T(); }
+		auto DestroyValue(void* dest) const -> void override { static_cast<T*>(dest)->~T(); }
+		auto CopyCompleteValue(void* dest, const void* src) const -> void override { *static_cast<T*>(dest) = *static_cast<const T*>(src); }
+	};
+
+	class FNumericProperty : public FProperty
+	{
+	public:
+		using FProperty::FProperty;
+
+		virtual auto IsInteger() const -> bool = 0;
+		virtual auto IsFloatingPoint() const -> bool = 0;
+		virtual auto SetIntPropertyValue(void* data, int64 value) const -> void = 0;
+		virtual auto SetIntPropertyValue(void* data, uint64 value) const -> void = 0;
+		virtual auto SetFloatingPointPropertyValue(void* data, double value) const -> void = 0;
+		virtual auto GetSignedIntPropertyValue(const void* data) const -> int64 = 0;
+		virtual auto GetUnsignedIntPropertyValue(const void* data) const -> uint64 = 0;
+		virtual auto GetFloatingPointPropertyValue(const void* data) const -> double = 0;
+	};
+
+	template<typename T>
+	class TNumericProperty : public TProperty<T, FNumericProperty>
+	{
+	public:
+		using TProperty<T, FNumericProperty>::TProperty;
+
+		auto IsInteger() const -> bool override { return std::is_integral_v<T>; }
+		auto IsFloatingPoint() const -> bool override { return std::is_floating_point_v<T>; }
+		auto SetIntPropertyValue(void* data, int64 value) const -> void override { *static_cast<T*>(data) = static_cast<T>(value); }
+		auto SetIntPropertyValue(void* data, uint64 value) const -> void override { *static_cast<T*>(data) = static_cast<T>(value); }
+		auto SetFloatingPointPropertyValue(void* data, double value) const -> void override { *static_cast<T*>(data) = static_cast<T>(value); }
+		auto GetSignedIntPropertyValue(const void* data) const -> int64 override { return static_cast<int64>(*static_cast<const T*>(data)); }
+		auto GetUnsignedIntPropertyValue(const void* data) const -> uint64 override { return static_cast<uint64>(*static_cast<const T*>(data)); }
+		auto GetFloatingPointPropertyValue(const void* data) const -> double override { return static_cast<double>(*static_cast<const T*>(data)); }
+
+		auto GetValueTypeHash(const void* src) const -> uint32 override
+		{
+			return static_cast<uint32>(std::hash<T>{}(*static_cast<const T*>(src)));
+		}
+
+		auto ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType* override
+		{
+			CharType* end = nullptr;
+			if constexpr (std::is_floating_point_v<T>) *static_cast<T*>(data) = static_cast<T>(std::wcstod(buffer, &end));
+			else if constexpr (std::is_signed_v<T>) *static_cast<T*>(data) = static_cast<T>(std::wcstoll(buffer, &end, 10));
+			else *static_cast<T*>(data) = static_cast<T>(std::wcstoull(buffer, &end, 10));
+			return end == buffer ? nullptr : end;
+		}
+
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override
+		{
+			valueStr = FString(fmt::format(STR("{}"), *static_cast<const T*>(propertyValue)));
+		}
+	};
+
+	class FInt8Property : public TNumericProperty<int8> { public: using TNumericProperty::TNumericProperty; };
+	class FInt16Property : public TNumericProperty<int16> { public: using TNumericProperty::TNumericProperty; };
+	class FIntProperty : public TNumericProperty<int32> { public: using TNumericProperty::TNumericProperty; };
+	class FInt64Property : public TNumericProperty<int64> { public: using TNumericProperty::TNumericProperty; };
+	class FByteProperty : public TNumericProperty<uint8> { public: using TNumericProperty::TNumericProperty; };
+	class FUInt16Property : public TNumericProperty<uint16> { public: using TNumericProperty::TNumericProperty; };
+	class FUInt32Property : public TNumericProperty<uint32> { public: using TNumericProperty::TNumericProperty; };
+	class FUInt64Property : public TNumericProperty<uint64> { public: using TNumericProperty::TNumericProperty; };
+	class FFloatProperty : public TNumericProperty<float> { public: using TNumericProperty::TNumericProperty; };
+	class FDoubleProperty : public TNumericProperty<double> { public: using TNumericProperty::TNumericProperty; };
+
+	// A bool in its own byte, or one bit of a bitfield byte when `fieldMask` isn't 0xFF
+	class FBoolProperty : public FProperty
+	{
+	private:
+		uint8 m_field_mask;
+
+	public:
+		explicit FBoolProperty(StringViewType name, uint8 fieldMask = 0xFF) : FProperty(name, 1, 1), m_field_mask(fieldMask) {}
+
+		auto GetFieldMask() const -> uint8 { return m_field_mask; }
+		auto GetPropertyValue(const void* data) const -> bool { return (*static_cast<const uint8*>(data) & m_field_mask) != 0; }
+		auto SetPropertyValue(void* data, bool value) const -> void
+		{
+			auto* byte = static_cast<uint8*>(data);
+			*byte = value ? (*byte | m_field_mask) : (*byte & ~m_field_mask);
+		}
+
+		auto ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType* override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	class FStrProperty : public TProperty<FString>
+	{
+	public:
+		using TProperty::TProperty;
+
+		auto GetValueTypeHash(const void* src) const -> uint32 override;
+		auto ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType* override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	class FNameProperty : public TProperty<FName>
+	{
+	public:
+		using TProperty::TProperty;
+
+		auto GetValueTypeHash(const void* src) const -> uint32 override;
+		auto ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType* override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	// Accepts plain text, NSLOCTEXT("Namespace", "Key", "Text") and LOCTABLE("Table", "Key").
+	// Localized text resolves to its source string, string table entries to "Table:Key".
+	class FTextProperty : public TProperty<FText>
+	{
+	public:
+		using TProperty::TProperty;
+
+		auto ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType* override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	class FObjectPropertyBase : public FProperty
+	{
+	public:
+		using FProperty::FProperty;
+	};
+
+	class FObjectProperty : public FObjectPropertyBase
+	{
+	public:
+		explicit FObjectProperty(StringViewType name) : FObjectPropertyBase(name, sizeof(UObject*), alignof(UObject*)) {}
+
+		auto ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType* override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	class FClassProperty : public FObjectProperty
+	{
+	public:
+		using FObjectProperty::FObjectProperty;
+	};
+
+	class FSoftObjectProperty : public TProperty<FSoftObjectPtr, FObjectPropertyBase>
+	{
+	public:
+		using TProperty::TProperty;
+
+		auto ImportText_Direct(const CharType* buffer, void* data, UObject*, int32, FOutputDevice*) const -> const CharType* override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	class FSoftClassProperty : public FSoftObjectProperty
+	{
+	public:
+		using FSoftObjectProperty::FSoftObjectProperty;
+	};
+
+	class FStructProperty : public FProperty
+	{
+	private:
+		UScriptStruct* m_struct;
+
+	public:
+		FStructProperty(StringViewType name, UScriptStruct* scriptStruct);
+
+		auto GetStruct() const -> UScriptStruct* { return m_struct; }
+
+		auto InitializeValue(void* dest) const -> void override;
+		auto DestroyValue(void* dest) const -> void override;
+		auto CopyCompleteValue(void* dest, const void* src) const -> void override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	class FArrayProperty : public FProperty
+	{
+	private:
+		std::unique_ptr<FProperty> m_inner;
+
+	public:
+		FArrayProperty(StringViewType name, std::unique_ptr<FProperty> inner)
+			: FProperty(name, sizeof(FScriptArray), alignof(FScriptArray)), m_inner(std::move(inner)) {}
+
+		auto GetInner() const -> FProperty* { return m_inner.get(); }
+
+		auto InitializeValue(void* dest) const -> void override { new (dest) FScriptArray(); }
+		auto DestroyValue(void* dest) const -> void override;
+		auto CopyCompleteValue(void* dest, const void* src) const -> void override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	class FMapProperty : public FProperty
+	{
+	private:
+		std::unique_ptr<FProperty> m_key;
+		std::unique_ptr<FProperty> m_value;
+
+	public:
+		FMapProperty(StringViewType name, std::unique_ptr<FProperty> key, std::unique_ptr<FProperty> value)
+			: FProperty(name, sizeof(FScriptMap), alignof(FScriptMap)), m_key(std::move(key)), m_value(std::move(value)) {}
+
+		auto GetKeyProp() const -> FProperty* { return m_key.get(); }
+		auto GetValueProp() const -> FProperty* { return m_value.get(); }
+		auto GetLayout() const -> FScriptMapLayout;
+
+		auto InitializeValue(void* dest) const -> void override { new (dest) FScriptMap(); }
+		auto DestroyValue(void* dest) const -> void override;
+		auto CopyCompleteValue(void* dest, const void* src) const -> void override;
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void*, UObject*, int32, UObject*) const -> void override;
+	};
+
+	class FEnumProperty : public FProperty
+	{
+	private:
+		std::unique_ptr<FNumericProperty> m_underlying;
+
+	public:
+		FEnumProperty(StringViewType name, std::unique_ptr<FNumericProperty> underlying)
+			: FProperty(name, underlying->GetSize(), underlying->GetMinAlignment()), m_underlying(std::move(underlying)) {}
+
+		auto GetUnderlyingProperty() const -> FNumericProperty* { return m_underlying.get(); }
+
+		auto ImportText_Direct(const CharType* buffer, void* data, UObject* owner, int32 portFlags, FOutputDevice* errorText) const -> const CharType* override
+		{
+			return m_underlying->ImportText_Direct(buffer, data, owner, portFlags, errorText);
+		}
+		auto ExportTextItem(FString& valueStr, const void* propertyValue, const void* defaultValue, UObject* parent, int32 portFlags, UObject* exportRootScope) const -> void override
+		{
+			m_underlying->ExportTextItem(valueStr, propertyValue, defaultValue, parent, portFlags, exportRootScope);
+		}
+	};
+
+	class UObjectBase
+	{
+	public:
+		virtual ~UObjectBase() = default;
+	};
+
+	// Objects register under their path for StaticFindObject and report their destruction to
+	// the delete listeners
+	class UObject : public UObjectBase
+	{
+	private:
+		StringType m_path;
+		FName m_name;
+		EObjectFlags m_flags = RF_NoFlags;
+
+	public:
+		explicit UObject(StringViewType path);
+		~UObject() override;
+
+		UObject(const UObject&) = delete;
+		auto operator=(const UObject&) -> UObject& = delete;
+
+		auto GetName() const -> StringType;
+		auto GetNamePrivate() const -> FName { return m_name; }
+		auto GetPathName() const -> StringType { return m_path; }
+		auto GetFullName() const -> StringType { return m_path; }
+
+		auto HasAnyFlags(EObjectFlags flags) const -> bool { return (m_flags & flags) != 0; }
+		auto SetFlags(EObjectFlags flags) -> void { m_flags = static_cast<EObjectFlags>(m_flags | flags); }
+		auto ClearFlags(EObjectFlags flags) -> void { m_flags = static_cast<EObjectFlags>(m_flags & ~flags); }
+
+		template<typename T>
+		auto IsA() const -> bool { return dynamic_cast<const T*>(this) != nullptr; }
+	};
+
+	class UScriptStruct : public UObject
+	{
+	private:
+		std::vector<std::unique_ptr<FProperty>> m_properties;
+		int32 m_size = 0;
+		int32 m_alignment = 1;
+
+	public:
+		using UObject::UObject;
+
+		// Appends a property at the next suitably aligned offset
+		template<typename T, typename... Args>
+		auto AddProperty(StringViewType name, Args&&... args) -> T*
+		{
+			auto property = std::make_unique<T>(name, std::forward<Args>(args)...);
+			T* result = property.get();
+			AddProperty(std::move(property));
+			return result;
+		}
+		auto AddProperty(std::unique_ptr<FProperty> property) -> void;
+
+		auto GetStructureSize() const -> int32 { return (m_size + m_alignment - 1) / m_alignment * m_alignment; }
+		auto GetMinAlignment() const -> int32 { return m_alignment; }
+		auto ForEachPropertyInChain() const -> std::vector<FProperty*>;
+
+		auto InitializeStruct(void* dest, int32 arrayDim = 1) const -> void;
+		auto DestroyStruct(void* dest, int32 arrayDim = 1) const -> void;
+		auto CopyScriptStruct(void* dest, const void* src, int32 arrayDim = 1) const -> void;
+	};
+
+	template<typename KeyType, typename ValueType>
+	struct TPair
+	{
+		KeyType Key;
+		ValueType Value;
+	};
+
+	struct FNameHash
+	{
+		auto operator()(const FName& name) const noexcept -> size_t
+		{
+			return (static_cast<size_t>(name.GetComparisonIndex()) << 32) | name.GetNumber();
+		}
+	};
+
+	// Pairs in insertion order with a hash index on the side. Removal swaps in the last pair.
+	template<typename KeyType, typename ValueType, typename Hash = FNameHash>
+	class TMap
+	{
+	private:
+		std::vector<TPair<KeyType, ValueType>> m_pairs;
+		std::unordered_map<KeyType, size_t, Hash> m_index;
+
+	public:
+		auto Add(const KeyType& key, const ValueType& value) -> ValueType&
+		{
+			auto [it, inserted] = m_index.try_emplace(key, m_pairs.size());
+			if (inserted) m_pairs.push_back({ key, value });
+			else m_pairs[it->second].Value = value;
+			return m_pairs[it->second].Value;
+		}
+
+		auto Find(const KeyType& key) -> ValueType*
+		{
+			auto it = m_index.find(key);
+			return it != m_index.end() ? &m_pairs[it->second].Value : nullptr;
+		}
+
+		auto Contains(const KeyType& key) const -> bool { return m_index.contains(key); }
+
+		auto Remove(const KeyType& key) -> int32
+		{
+			auto it = m_index.find(key);
+			if (it == m_index.end()) return 0;
+
+			size_t index = it->second;
+			m_index.erase(it);
+			if (index != m_pairs.size() - 1)
+			{
+				m_pairs[index] = std::move(m_pairs.back());
+				m_index[m_pairs[index].Key] = index;
+			}
+			m_pairs.pop_back();
+			return 1;
+		}
+
+		auto Empty() -> void
+		{
+			m_pairs.clear();
+			m_index.clear();
+		}
+
+		auto Num() const -> int32 { return static_cast<int32>(m_pairs.size()); }
+		auto begin() { return m_pairs.begin(); }
+		auto end() { return m_pairs.end(); }
+		auto begin() const { return m_pairs.begin(); }
+		auto end() const { return m_pairs.end(); }
+	};
+
+	class UDataTable : public UObject
+	{
+	private:
+		UScriptStruct* m_row_struct;
+		TMap<FName, uint8*> m_row_map;
+
+	public:
+		UDataTable(StringViewType path, UScriptStruct* rowStruct) : UObject(path), m_row_struct(rowStruct) {}
+		~UDataTable() override { EmptyTable(); }
+
+		auto GetRowStruct() const -> UScriptStruct* { return m_row_struct; }
+		auto GetRowMap() -> TMap<FName, uint8*>& { return m_row_map; }
+		auto FindRowUnchecked(FName rowName) -> uint8*;
+		auto RemoveRow(FName rowName) -> void;
+		auto EmptyTable() -> void;
+	};
+
+	struct FUObjectDeleteListener
+	{
+		virtual ~FUObjectDeleteListener() = default;
+		virtual auto NotifyUObjectDeleted(const UObjectBase* object, int32 index) -> void = 0;
+		virtual auto OnUObjectArrayShutdown() -> void = 0;
+	};
+
+	struct UObjectArray
+	{
+		static auto AddUObjectDeleteListener(FUObjectDeleteListener* listener) -> void;
+		static auto RemoveUObjectDeleteListener(FUObjectDeleteListener* listener) -> void;
+	};
+
+	struct UObjectGlobals
+	{
+		static auto FindObjectByPath(StringViewType path) -> UObject*;
+
+		template<typename ObjectType = UObject*>
+		static auto StaticFindObject(void* objectClass, UObject* inObjectPackage, StringViewType origInName, bool exactClass = false) -> ObjectType
+		{
+			return static_cast<ObjectType>(FindObjectByPath(origInName));
+		}
+
+		// Calls `callable` with every live object until it returns LoopAction::Break
+		static auto ForEachUObject(const std::function<LoopAction(UObject*, int32, int32)>& callable) -> void;
+	};
+
+	struct FStaticConstructObjectParameters
+	{
+		UObject* Outer = nullptr;
+		FName Name = {};
+		EObjectFlags SetFlags = RF_NoFlags;
+	};
+
+	namespace Hook
+	{
+		using StaticConstructObjectPostCallback = std::function<UObject*(const FStaticConstructObjectParameters&, UObject*)>;
+
+		auto RegisterStaticConstructObjectPostCallback(StaticConstructObjectPostCallback callback) -> void;
+
+		// Not in UE4SS: runs the post callbacks for an object the caller just constructed, the way
+		// the engine's StaticConstructObject would
+		auto RunStaticConstructObjectPostCallbacks(UObject* object) -> void;
+	}
+}
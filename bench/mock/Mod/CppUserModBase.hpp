@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../MockUnreal.hpp"
+#include "../LuaMadeSimple/LuaMadeSimple.hpp"
+
+namespace RC
+{
+	// The hooks UE4SS calls on a C++ mod. The benchmarks call them directly.
+	class CppUserModBase
+	{
+	public:
+		StringType ModName;
+		StringType ModVersion;
+		StringType ModDescription;
+		StringType ModAuthors;
+
+		CppUserModBase() = default;
+		virtual ~CppUserModBase() = default;
+
+		virtual auto on_update() -> void {}
+		virtual auto on_unreal_init() -> void {}
+		virtual auto on_lua_start(LuaMadeSimple::Lua& lua,
+			LuaMadeSimple::Lua& main_lua,
+			LuaMadeSimple::Lua& async_lua,
+			LuaMadeSimple::Lua* hook_lua) -> void {}
+	};
+}
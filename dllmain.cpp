@@ -4,495 +4,4670 @@
 #include <Unreal/UObject.hpp>
 #include <Unreal/UClass.hpp>
 #include <Unreal/UScriptStruct.hpp>
+#include <Unreal/UObjectArray.hpp>
+#include <Unreal/Hooks.hpp>
 #include <Unreal/Engine/UDataTable.hpp>
 #include <Unreal/FProperty.hpp>
 #include <Unreal/Property/FStructProperty.hpp>
 #include <Unreal/Property/FStrProperty.hpp>
 #include <Unreal/Property/FTextProperty.hpp>
 #include <Unreal/Property/FNumericProperty.hpp>
+#include <Unreal/Property/NumericPropertyTypes.hpp>
 #include <Unreal/Property/FBoolProperty.hpp>
 #include <Unreal/Property/FNameProperty.hpp>
 #include <Unreal/Property/FEnumProperty.hpp>
+#include <Unreal/Property/FArrayProperty.hpp>
+#include <Unreal/Property/FMapProperty.hpp>
 #include <Unreal/FText.hpp>
 #include <Unreal/FString.hpp>
 #include <LuaMadeSimple/LuaMadeSimple.hpp>
 
+#include "CallTrace.hpp"
+#include "FieldValue.hpp"
+#include "RowCache.hpp"
+#include "RowImport.hpp"
+#include "TFWWorkbenchApi.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <cwctype>
+#include <exception>
+#include <filesystem>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <span>
+#include <unordered_set>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+constexpr size_t INVENTORY_ITEM_DETAILS_SIZE = 0x240;
+
+// Verbose diagnostics on the row-writing path. Compiled out entirely when 0, and when
+// compiled in nothing (arguments included) is evaluated unless enabled at runtime.
+#ifndef TFWWORKBENCH_VERBOSE_LOGGING
+#define TFWWORKBENCH_VERBOSE_LOGGING 1
+#endif
+
+// Lua stack balance check around every top-level field write
+#ifndef TFWWORKBENCH_STACK_CHECKS
+#ifdef NDEBUG
+#define TFWWORKBENCH_STACK_CHECKS 0
+#else
+#define TFWWORKBENCH_STACK_CHECKS 1
+#endif
+#endif
+
+// Binary per-field trace records, see TraceRing
+#ifndef TFWWORKBENCH_TRACING
+#define TFWWORKBENCH_TRACING 1
+#endif
+
+// Per-table, per-property-kind and per-cache counters, see WorkbenchStats
+#ifndef TFWWORKBENCH_STATS
+#define TFWWORKBENCH_STATS 1
+#endif
+
+#if TFWWORKBENCH_VERBOSE_LOGGING
+#define TFW_LOG_VERBOSE(...) \
+	do { if (TFWWorkbench::s_verbose_logging.load(std::memory_order_relaxed)) Output::send<LogLevel::Verbose>(__VA_ARGS__); } while (0)
+#else
+#define TFW_LOG_VERBOSE(...) do {} while (0)
+#endif
+
+using namespace RC;
+using namespace RC::Unreal;
+
+// Lets unordered containers keyed on std::string be queried with a std::string_view
+struct StringHash
+{
+	using is_transparent = void;
+
+	auto operator()(std::string_view value) const noexcept -> size_t
+	{
+		return std::hash<std::string_view>{}(value);
+	}
+};
+
+// Copies the value at `index` of the Lua stack into a FieldValue, leaving the stack unchanged.
+// Functions, userdata and threads become nil. `tables` holds the tables being copied around
+// the value, a table that contains itself becomes nil where it repeats.
+static auto FieldValueFromLua(lua_State* L, int index, std::vector<const void*>& tables) -> FieldValue
+{
+	index = lua_absindex(L, index);
+	switch (lua_type(L, index))
+	{
+	case LUA_TBOOLEAN:
+		return FieldValue::from_bool(lua_toboolean(L, index));
+	case LUA_TNUMBER:
+		return lua_isinteger(L, index) ? FieldValue::from_integer(lua_tointeger(L, index)) : FieldValue::from_number(lua_tonumber(L, index));
+	case LUA_TSTRING:
+	{
+		size_t length = 0;
+		const char* value = lua_tolstring(L, index, &length);
+		return FieldValue::from_string({ value, length });
+	}
+	case LUA_TTABLE:
+	{
+		const void* address = lua_topointer(L, index);
+		if (std::find(tables.begin(), tables.end(), address) != tables.end())
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Table contains itself, the inner reference is left out\n"));
+			return {};
+		}
+
+		FieldValue table = FieldValue::make_table();
+		if (tables.size() >= FieldValue::MaxDepth)
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Table nested deeper than {} levels, truncating\n"), FieldValue::MaxDepth);
+			return table;
+		}
+		// Each level holds a key and a value on the stack. Not raised as a Lua error, which
+		// would unwind past the FieldValues being built.
+		if (!lua_checkstack(L, 2))
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Table nested too deeply for the Lua stack, truncating\n"));
+			return table;
+		}
+
+		tables.push_back(address);
+		// The sequence part goes first and in order, array properties rely on it
+		lua_Integer length = static_cast<lua_Integer>(lua_rawlen(L, index));
+		table.get_table().reserve(static_cast<size_t>(length));
+		for (lua_Integer i = 1; i <= length; i++)
+		{
+			lua_rawgeti(L, index, i);
+			table.add(FieldValue::from_integer(i), FieldValueFromLua(L, -1, tables));
+			lua_pop(L, 1);
+		}
+
+		lua_pushnil(L);
+		while (lua_next(L, index) != 0)
+		{
+			bool inSequence = lua_isinteger(L, -2) && lua_tointeger(L, -2) >= 1 && lua_tointeger(L, -2) <= length;
+			if (!inSequence)
+			{
+				table.add(FieldValueFromLua(L, -2, tables), FieldValueFromLua(L, -1, tables));
+			}
+			lua_pop(L, 1);
+		}
+		tables.pop_back();
+		return table;
+	}
+	default:
+		return {};
+	}
+}
+
+static auto FieldValueFromLua(lua_State* L, int index) -> FieldValue
+{
+	std::vector<const void*> tables;
+	return FieldValueFromLua(L, index, tables);
+}
+
+// Copies a value passed through the C API into a FieldValue. `tables` holds the entry arrays
+// being copied around the value, a table that contains itself becomes nil where it repeats.
+static auto FieldValueFromApi(const TFWValue& value, std::vector<const void*>& tables) -> FieldValue
+{
+	switch (value.type)
+	{
+	case TFW_VALUE_BOOL:
+		return FieldValue::from_bool(value.as.boolean != 0);
+	case TFW_VALUE_INTEGER:
+		return FieldValue::from_integer(value.as.integer);
+	case TFW_VALUE_NUMBER:
+		return FieldValue::from_number(value.as.number);
+	case TFW_VALUE_STRING:
+		return FieldValue::from_string(value.as.string.data ? std::string_view(value.as.string.data, value.as.string.size) : std::string_view());
+	case TFW_VALUE_TABLE:
+	{
+		const void* address = value.as.table.entries;
+		if (address && std::find(tables.begin(), tables.end(), address) != tables.end())
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Table contains itself, the inner reference is left out\n"));
+			return {};
+		}
+
+		FieldValue table = FieldValue::make_table();
+		if (tables.size() >= FieldValue::MaxDepth)
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Table nested deeper than {} levels, truncating\n"), FieldValue::MaxDepth);
+			return table;
+		}
+
+		if (!address) return table;
+
+		tables.push_back(address);
+		table.get_table().reserve(value.as.table.count);
+		for (size_t i = 0; i < value.as.table.count; i++)
+		{
+			const TFWEntry& entry = value.as.table.entries[i];
+			table.add(FieldValueFromApi(entry.key, tables), FieldValueFromApi(entry.value, tables));
+		}
+		tables.pop_back();
+		return table;
+	}
+	default:
+		return {};
+	}
+}
+
+static auto FieldValueFromApi(const TFWValue& value) -> FieldValue
+{
+	std::vector<const void*> tables;
+	return FieldValueFromApi(value, tables);
+}
+
+// Pushes a copy of `value` onto the Lua stack, the reverse of FieldValueFromLua
+static auto FieldValueToLua(lua_State* L, const FieldValue& value) -> void
+{
+	switch (value.get_type())
+	{
+	case FieldValue::Type::Bool:
+		lua_pushboolean(L, value.get_bool());
+		return;
+	case FieldValue::Type::Integer:
+		lua_pushinteger(L, value.get_integer());
+		return;
+	case FieldValue::Type::Number:
+		lua_pushnumber(L, value.get_number());
+		return;
+	case FieldValue::Type::String:
+		lua_pushlstring(L, value.get_string().data(), value.get_string().size());
+		return;
+	case FieldValue::Type::Table:
+		luaL_checkstack(L, 3, "FieldValue nested too deeply");
+		lua_createtable(L, 0, static_cast<int>(value.get_table().size()));
+		for (const FieldValue::Entry& entry : value.get_table())
+		{
+			if (entry.key.is_nil()) continue;
+
+			FieldValueToLua(L, entry.key);
+			FieldValueToLua(L, entry.value);
+			lua_rawset(L, -3);
+		}
+		return;
+	default:
+		lua_pushnil(L);
+		return;
+	}
+}
+
+struct StructWritePlan;
+
+enum class PropertyKind : uint8
+{
+	Unsupported,
+	Text,
+	Str,
+	Name,
+	Int,
+	Float,
+	Bool,
+	SoftObject,
+	Double,
+	Enum,
+	Object,
+	Map,
+	Array,
+	Struct,
+	Int8,
+	Int16,
+	Int64,
+	Byte,
+	UInt16,
+	UInt32,
+	UInt64,
+};
+
+constexpr size_t PropertyKindCount = static_cast<size_t>(PropertyKind::UInt64) + 1;
+
+static auto PropertyKindName(PropertyKind kind) -> std::string_view
+{
+	static constexpr std::string_view names[PropertyKindCount] = {
+		"Unsupported", "Text", "Str", "Name", "Int", "Float", "Bool",
+		"SoftObject", "Double", "Enum", "Object", "Map", "Array", "Struct",
+		"Int8", "Int16", "Int64", "Byte", "UInt16", "UInt32", "UInt64",
+	};
+	return names[static_cast<size_t>(kind)];
+}
+
+// A numeric property type and the native type its values are stored as
+template<typename TProperty, typename TValue, PropertyKind Kind>
+struct NumericCodec
+{
+	using Property = TProperty;
+	using Value = TValue;
+	static constexpr PropertyKind kind = Kind;
+};
+
+// Every FNumericProperty width. The typed setters, array fills and row view reads are
+// instantiated from this list.
+using NumericCodecs = std::tuple<
+	NumericCodec<FInt8Property, int8, PropertyKind::Int8>,
+	NumericCodec<FInt16Property, int16, PropertyKind::Int16>,
+	NumericCodec<FIntProperty, int32, PropertyKind::Int>,
+	NumericCodec<FInt64Property, int64, PropertyKind::Int64>,
+	NumericCodec<FByteProperty, uint8, PropertyKind::Byte>,
+	NumericCodec<FUInt16Property, uint16, PropertyKind::UInt16>,
+	NumericCodec<FUInt32Property, uint32, PropertyKind::UInt32>,
+	NumericCodec<FUInt64Property, uint64, PropertyKind::UInt64>,
+	NumericCodec<FFloatProperty, float, PropertyKind::Float>,
+	NumericCodec<FDoubleProperty, double, PropertyKind::Double>
+>;
+
+// Converts `value` to the numeric type T. Integers that don't fit T and fractional numbers for
+// integer types are rejected, so such a value is skipped like a mistyped one instead of wrapping.
+template<typename T>
+static auto ToNumeric(const FieldValue& value, T& result) -> bool
+{
+	if constexpr (std::is_floating_point_v<T>)
+	{
+		double number = 0.0;
+		if (!value.to_number(number)) return false;
+		result = static_cast<T>(number);
+		return true;
+	}
+	else if (value.is_integer())
+	{
+		int64_t integer = value.get_integer();
+		if (!std::in_range<T>(integer)) return false;
+		result = static_cast<T>(integer);
+		return true;
+	}
+	else if (value.is_number())
+	{
+		// Lua 5.4 makes floats of divisions, 10 / 2 is 5.0
+		double number = value.get_number();
+		if (number != std::trunc(number) ||
+			number < static_cast<double>(std::numeric_limits<T>::min()) ||
+			number >= std::ldexp(1.0, std::numeric_limits<T>::digits))
+		{
+			return false;
+		}
+		result = static_cast<T>(number);
+		return true;
+	}
+	else if (value.is_string())
+	{
+		std::string_view text = value.get_string();
+		T parsed{};
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+		if (error != std::errc() || end != text.data() + text.size()) return false;
+		result = parsed;
+		return true;
+	}
+	return false;
+}
+
+// Everything needed to write one property from Lua, resolved once per property
+struct PropertyWritePlan
+{
+	// Returns false when the value doesn't convert, leaving the property as it was
+	using Setter = bool(*)(const FieldValue&, const PropertyWritePlan&, void*);
+	// Writes a whole sequence into contiguous, uninitialized elements of this property. Returns
+	// the index of the first element that doesn't convert, or the element count.
+	using ArrayFill = size_t(*)(const std::vector<FieldValue::Entry>&, void*);
+
+	FProperty* property = nullptr;
+	int32 offset = 0;
+	StringType name;
+	// The property's name as an FName, which trace records refer to it by
+	FName fname = {};
+	PropertyKind kind = PropertyKind::Unsupported;
+	Setter setter = nullptr;
+	// Set for numeric properties, so arrays of them are filled without a setter call per element
+	ArrayFill fill = nullptr;
+	// The value is plain bytes (numbers, bools, enums, structs of those) and can be copied between rows
+	bool trivial = false;
+	// Set for struct properties and for array/map plans whose elements are structs
+	const StructWritePlan* structPlan = nullptr;
+	// Array element or map key
+	std::unique_ptr<PropertyWritePlan> inner;
+	// Map value
+	std::unique_ptr<PropertyWritePlan> value;
+};
+
+// Field name -> property plan for a UScriptStruct, compiled the first time a struct is written
+struct StructWritePlan
+{
+	UScriptStruct* scriptStruct = nullptr;
+	std::unordered_map<std::string, PropertyWritePlan, StringHash, std::equal_to<>> fields = {};
+	// Every field in property order
+	std::vector<const PropertyWritePlan*> fieldOrder = {};
+	// Fields that are plain bytes, in property order, and whether that covers every field
+	std::vector<const PropertyWritePlan*> trivialFields = {};
+	bool trivial = false;
+	// Hash of the struct size and each field's name, kind, offset and size. Row cache images
+	// are only reused while it matches.
+	uint64 layoutHash = 0;
+
+	auto Find(std::string_view fieldName) const -> const PropertyWritePlan*
+	{
+		if (auto it = fields.find(fieldName); it != fields.end())
+		{
+			return &it->second;
+		}
+
+		// Property names are FNames and compare case-insensitively
+		for (const auto& [name, plan] : fields)
+		{
+			if (name.size() == fieldName.size() && std::equal(name.begin(), name.end(), fieldName.begin(),
+				[](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); }))
+			{
+				return &plan;
+			}
+		}
+		return nullptr;
+	}
+};
+
+// Counters behind GetWorkbenchStats. They are bumped from the game thread, the build workers and
+// the Lua states alike, with relaxed atomics, and only ever read as a rough snapshot.
+class WorkbenchStats
+{
+public:
+	struct Cache
+	{
+		std::atomic<uint64> hits = 0;
+		std::atomic<uint64> misses = 0;
+
+		auto Record(bool hit) -> void
+		{
+			if (!Enabled()) return;
+			(hit ? hits : misses).fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	struct Timer
+	{
+		std::atomic<uint64> count = 0;
+		std::atomic<uint64> nanoseconds = 0;
+		std::atomic<uint64> maxNanoseconds = 0;
+
+		auto Add(uint64 addCount, uint64 addNanoseconds, uint64 addMaxNanoseconds) -> void
+		{
+			count.fetch_add(addCount, std::memory_order_relaxed);
+			nanoseconds.fetch_add(addNanoseconds, std::memory_order_relaxed);
+			uint64 max = maxNanoseconds.load(std::memory_order_relaxed);
+			while (addMaxNanoseconds > max && !maxNanoseconds.compare_exchange_weak(max, addMaxNanoseconds, std::memory_order_relaxed)) {}
+		}
+	};
+
+	// One configured table. The row timer covers writing the fields of each row, on whichever
+	// thread built it.
+	struct Table
+	{
+		std::atomic<uint64> rowsWritten = 0;
+		std::atomic<uint64> rowsFailed = 0;
+		// Written rows whose input had not changed since the last write, and rows patched in
+		// place with only the fields that had, see incrementalWrites
+		std::atomic<uint64> rowsUnchanged = 0;
+		std::atomic<uint64> rowsPatched = 0;
+		std::atomic<uint64> fieldsWritten = 0;
+		std::atomic<uint64> unknownFields = 0;
+		Timer rows = {};
+		std::atomic<uint64> resolveNanoseconds = 0;
+		Cache rowCache = {};
+	};
+
+	struct KindTotals
+	{
+		uint64 count = 0;
+		uint64 nanoseconds = 0;
+		uint64 maxNanoseconds = 0;
+	};
+
+	static std::atomic<bool> s_enabled;
+
+private:
+	// The per-kind field timers of one thread. Only that thread writes them, so a field costs a
+	// few plain loads and stores rather than contended read-modify-writes.
+	struct ThreadFields
+	{
+		struct Kind
+		{
+			std::atomic<uint64> count = 0;
+			std::atomic<uint64> nanoseconds = 0;
+			std::atomic<uint64> maxNanoseconds = 0;
+		};
+		std::array<Kind, PropertyKindCount> kinds = {};
+	};
+
+	// This thread's slot in the stats it last wrote to, and the fields of the row it is writing
+	struct ThreadState
+	{
+		uint64 owner = 0;
+		ThreadFields* fields = nullptr;
+		uint64 rowFields = 0;
+		uint64 unknownFields = 0;
+	};
+
+	static std::atomic<uint64> s_next_id;
+	static thread_local ThreadState t_state;
+
+	// Tells apart the instances of a mod that was unloaded and loaded again
+	uint64 m_id = s_next_id.fetch_add(1, std::memory_order_relaxed);
+	mutable std::mutex m_threads_mutex;
+	// Kept after their thread exits, so its counts stay in the totals
+	std::vector<std::unique_ptr<ThreadFields>> m_threads = {};
+
+	static auto Bump(std::atomic<uint64>& counter, uint64 value) -> void
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	auto GetThreadState() -> ThreadState&
+	{
+		ThreadState& state = t_state;
+		if (state.owner != m_id)
+		{
+			auto fields = std::make_unique<ThreadFields>();
+			state = { m_id, fields.get() };
+
+			std::lock_guard lock(m_threads_mutex);
+			m_threads.push_back(std::move(fields));
+		}
+		return state;
+	}
+
+public:
+	static auto Enabled() -> bool
+	{
+#if TFWWORKBENCH_STATS
+		return s_enabled.load(std::memory_order_relaxed);
+#else
+		return false;
+#endif
+	}
+
+	auto RecordField(PropertyKind kind, uint64 nanoseconds) -> void
+	{
+		ThreadState& state = GetThreadState();
+		ThreadFields::Kind& counters = state.fields->kinds[static_cast<size_t>(kind)];
+		Bump(counters.count, 1);
+		Bump(counters.nanoseconds, nanoseconds);
+		if (nanoseconds > counters.maxNanoseconds.load(std::memory_order_relaxed))
+		{
+			counters.maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+		}
+		state.rowFields++;
+	}
+
+	auto RecordUnknownField() -> void
+	{
+		GetThreadState().unknownFields++;
+	}
+
+	// Accounts the fields recorded on this thread since the last call to `table`, as one row
+	auto RecordRow(Table& table, uint64 nanoseconds) -> void
+	{
+		ThreadState& state = GetThreadState();
+		table.fieldsWritten.fetch_add(std::exchange(state.rowFields, 0), std::memory_order_relaxed);
+		table.unknownFields.fetch_add(std::exchange(state.unknownFields, 0), std::memory_order_relaxed);
+		table.rows.Add(1, nanoseconds, nanoseconds);
+	}
+
+	auto FieldTotals() const -> std::array<KindTotals, PropertyKindCount>
+	{
+		std::array<KindTotals, PropertyKindCount> totals = {};
+		std::lock_guard lock(m_threads_mutex);
+		for (const auto& thread : m_threads)
+		{
+			for (size_t i = 0; i < PropertyKindCount; i++)
+			{
+				const ThreadFields::Kind& counters = thread->kinds[i];
+				totals[i].count += counters.count.load(std::memory_order_relaxed);
+				totals[i].nanoseconds += counters.nanoseconds.load(std::memory_order_relaxed);
+				totals[i].maxNanoseconds = std::max(totals[i].maxNanoseconds, counters.maxNanoseconds.load(std::memory_order_relaxed));
+			}
+		}
+		return totals;
+	}
+};
+
+// UTF-8 -> FName and UTF-8 -> wide string conversions, cached for the lifetime of the mod.
+// Row names, FName values and map keys repeat heavily across a mod pack, so after the first
+// sighting a string costs one hash lookup instead of a UTF-16 allocation plus a trip through
+// the global name table. Lookups take a shared lock so every Lua state can use the cache.
+class NameCache
+{
+private:
+	mutable std::shared_mutex m_mutex;
+	std::unordered_map<std::string, FName, StringHash, std::equal_to<>> m_names = {};
+	// Node based, so references handed out stay valid while other threads insert
+	std::unordered_map<std::string, StringType, StringHash, std::equal_to<>> m_wide = {};
+	WorkbenchStats::Cache m_stats = {};
+
+public:
+	auto Stats() const -> const WorkbenchStats::Cache& { return m_stats; }
+
+	auto ToName(std::string_view value) -> FName
+	{
+		{
+			std::shared_lock lock(m_mutex);
+			if (auto it = m_names.find(value); it != m_names.end())
+			{
+				m_stats.Record(true);
+				return it->second;
+			}
+		}
+		m_stats.Record(false);
+
+		FName name(ToWide(value).c_str(), FNAME_Add);
+
+		std::unique_lock lock(m_mutex);
+		return m_names.try_emplace(std::string(value), name).first->second;
+	}
+
+	auto ToWide(std::string_view value) -> const StringType&
+	{
+		{
+			std::shared_lock lock(m_mutex);
+			if (auto it = m_wide.find(value); it != m_wide.end())
+			{
+				return it->second;
+			}
+		}
+
+		StringType wide = to_wstring(value);
+
+		std::unique_lock lock(m_mutex);
+		return m_wide.try_emplace(std::string(value), std::move(wide)).first->second;
+	}
+};
+
+// Shared FText instances keyed by their source. Copies of an FText share the same
+// refcounted text data, so rows using the same display string also share its storage.
+class TextCache
+{
+private:
+	mutable std::shared_mutex m_mutex;
+	std::unordered_map<std::string, FText, StringHash, std::equal_to<>> m_texts = {};
+	mutable WorkbenchStats::Cache m_stats = {};
+
+public:
+	auto Stats() const -> const WorkbenchStats::Cache& { return m_stats; }
+
+	auto Find(std::string_view key, FText& text) const -> bool
+	{
+		std::shared_lock lock(m_mutex);
+		if (auto it = m_texts.find(key); it != m_texts.end())
+		{
+			text = it->second;
+			m_stats.Record(true);
+			return true;
+		}
+		m_stats.Record(false);
+		return false;
+	}
+
+	auto Add(std::string_view key, const FText& text) -> void
+	{
+		std::unique_lock lock(m_mutex);
+		m_texts.try_emplace(std::string(key), text);
+	}
+
+	// Culture invariant text built straight from the string, without going through the text literal parser
+	auto FromString(std::string_view value) -> FText
+	{
+		FText text;
+		if (!Find(value, text))
+		{
+			text = FText(StringViewType(to_wstring(value)));
+			Add(value, text);
+		}
+		return text;
+	}
+};
+
+// Asset path -> UObject* for FObjectProperty values. Only successful lookups are cached, so
+// an asset that loads later is still found. Entries are dropped when the object is deleted.
+class ObjectCache : public FUObjectDeleteListener
+{
+private:
+	mutable std::shared_mutex m_mutex;
+	std::unordered_map<std::string, UObject*, StringHash, std::equal_to<>> m_objects = {};
+	// Every cached path of an object. StaticFindObject ignores case, so paths spelled
+	// differently can find the same object, and all of them go when it is destroyed.
+	std::unordered_multimap<const void*, std::string> m_paths = {};
+	WorkbenchStats::Cache m_stats = {};
+
+public:
+	auto Stats() const -> const WorkbenchStats::Cache& { return m_stats; }
+
+	auto Find(std::string_view path) -> UObject*
+	{
+		{
+			std::shared_lock lock(m_mutex);
+			if (auto it = m_objects.find(path); it != m_objects.end())
+			{
+				m_stats.Record(true);
+				return it->second;
+			}
+		}
+		m_stats.Record(false);
+
+		UObject* object = UObjectGlobals::StaticFindObject(nullptr, nullptr, to_wstring(path));
+		if (object)
+		{
+			std::unique_lock lock(m_mutex);
+			auto [it, inserted] = m_objects.try_emplace(std::string(path), object);
+			if (inserted)
+			{
+				m_paths.emplace(object, it->first);
+			}
+		}
+		return object;
+	}
+
+	auto Clear() -> void
+	{
+		std::unique_lock lock(m_mutex);
+		m_objects.clear();
+		m_paths.clear();
+	}
+
+	auto NotifyUObjectDeleted(const UObjectBase* object, [[maybe_unused]] int32 index) -> void override
+	{
+		// Called for every object the engine destroys, nearly none of them cached
+		{
+			std::shared_lock lock(m_mutex);
+			if (!m_paths.contains(object)) return;
+		}
+
+		std::unique_lock lock(m_mutex);
+		auto [first, last] = m_paths.equal_range(object);
+		for (auto it = first; it != last; ++it) m_objects.erase(it->second);
+		m_paths.erase(first, last);
+	}
+
+	auto OnUObjectArrayShutdown() -> void override
+	{
+		Clear();
+	}
+};
+
+// Asset path -> parsed soft object pointer for FSoftObjectProperty values. A path is run
+// through ImportText once and later writes copy the parsed value. Soft class and soft object
+// properties share the FSoftObjectPtr layout, so one entry serves both.
+class SoftPathCache
+{
+private:
+	// The parsed values are never passed to DestroyValue, their owning properties may already be
+	// gone when the mod unloads. Only the path strings inside them outlive the buffers.
+	mutable std::shared_mutex m_mutex;
+	std::unordered_map<std::string, std::unique_ptr<uint8[]>, StringHash, std::equal_to<>> m_paths = {};
+	WorkbenchStats::Cache m_stats = {};
+
+public:
+	auto Stats() const -> const WorkbenchStats::Cache& { return m_stats; }
+
+	auto Write(FProperty* property, std::string_view path, void* propertyPtr) -> void
+	{
+		{
+			std::shared_lock lock(m_mutex);
+			if (auto it = m_paths.find(path); it != m_paths.end())
+			{
+				m_stats.Record(true);
+				property->CopyCompleteValue(propertyPtr, it->second.get());
+				return;
+			}
+		}
+		m_stats.Record(false);
+
+		property->ImportText_Direct(to_wstring(path).c_str(), propertyPtr, nullptr, PPF_None, nullptr);
+
+		auto value = std::make_unique<uint8[]>(property->GetSize());
+		property->InitializeValue(value.get());
+		property->CopyCompleteValue(value.get(), propertyPtr);
+
+		std::unique_lock lock(m_mutex);
+		m_paths.try_emplace(std::string(path), std::move(value));
+	}
+};
+
+// The input a row was last written from, kept with incrementalWrites on so writing the same
+// row again can be skipped or narrowed down to the fields that changed
+struct RowInput
+{
+	// The row the input was written into, and a hash of its bytes after the write. The input no
+	// longer describes the table's row once that has been replaced by something else, even by a
+	// row allocated at the same address: its strings, arrays and maps have buffers of their own.
+	const uint8* row = nullptr;
+	uint64 rowHash = 0;
+	uint64 hash = 0;
+	// Hashes of each field's name and value, sorted by name hash
+	std::vector<std::pair<uint64, uint64>> fields = {};
+};
+
+// A secondary index over one field of a table's rows, built by FindDataTableRows the first time
+// the field is queried and refiled by every row the workbench writes afterwards
+struct RowIndex
+{
+	// Fields from the row down to the indexed value. Arrays and maps on the way contribute all
+	// of their elements, and a map the path ends at its keys.
+	std::vector<const PropertyWritePlan*> path = {};
+	// The plan of the indexed values themselves
+	const PropertyWritePlan* leaf = nullptr;
+	struct Row
+	{
+		FName name = {};
+		// What queries return, converted once
+		std::string utf8Name;
+		// So a rewritten row can be taken out again
+		std::vector<std::string> keys;
+	};
+
+	// Every row with at least one key, by FName id
+	std::unordered_map<uint64, Row> entries = {};
+	// Rows by key, see ReadIndexKey
+	std::unordered_map<std::string, std::vector<const Row*>> rows = {};
+	// Row count of the table when the index was last brought up to date, -1 before it's built.
+	// Rows added or removed by anything but the workbench change the count, and the index is
+	// rebuilt by the next query. Workbench writes only carry it along while it was current.
+	int32 rowCount = -1;
+};
+
+// What the rows of a table are built against. Rows built on the RowBuildPool workers carry a
+// copy taken when they were staged, since the DataTableEntry is reset when its table is destroyed.
+struct RowLayout
+{
+	UDataTable* table = nullptr;
+	UScriptStruct* rowStruct = nullptr;
+	const StructWritePlan* plan = nullptr;
+};
+
+// A table configured through ConfigureDataTables. Its handle is the index into the registry
+// plus one and stays valid for the lifetime of the mod.
+struct DataTableEntry
+{
+	int32 handle = 0;
+	std::string name;
+	StringType path;
+	// Filled in by the first resolution sweep that finds the table, see ResolveDataTables, and
+	// cleared when the table is destroyed
+	std::atomic<bool> resolved = false;
+	// Object name part of the path, None until a loaded object has that name
+	FName objectName = {};
+	// Whether the sweeps missing the table were reported
+	bool reportedMissing = false;
+	UDataTable* table = nullptr;
+	UScriptStruct* rowStruct = nullptr;
+	const StructWritePlan* plan = nullptr;
+	// Rows can be built by the RowBuildPool workers, see CanBuildOffThread
+	bool offThreadBuild = false;
+	// Bumped after every applied write, so row views know to look their row up again
+	std::atomic<uint64> generation = 0;
+	// Bumped when the table is destroyed. Row views and staged rows of an earlier table are
+	// dropped, see ResolveRowView and StagedRow.
+	std::atomic<uint32> tableEpoch = 0;
+	// Counters only, bumped through const references as well
+	mutable WorkbenchStats::Table stats = {};
+	// Inputs of the rows last written with incrementalWrites on, and the rows those writes added
+	// (true) or changed (false) since GetDataTableRowChanges was last called. Only written on the
+	// game thread, under the mutex since the Lua states read them.
+	mutable std::mutex inputsMutex;
+	mutable std::unordered_map<std::string, RowInput, StringHash, std::equal_to<>> inputs = {};
+	mutable std::unordered_map<std::string, bool, StringHash, std::equal_to<>> changes = {};
+	// Secondary indexes by field path, see FindDataTableRows. Queried from the Lua states and
+	// refiled on the game thread.
+	mutable std::shared_mutex indexesMutex;
+	mutable std::unordered_map<std::string, std::unique_ptr<RowIndex>, StringHash, std::equal_to<>> indexes = {};
+	mutable std::atomic<bool> indexed = false;
+
+	auto Layout() const -> RowLayout { return { table, rowStruct, plan }; }
+};
+
+// The objects of resolved tables, so their entries can be reset when the table is destroyed
+// and resolved again once it is loaded anew. Several entries may share a table. Also holds the
+// DataTables constructed while writes wait for a table, until they have finished loading.
+class DataTableWatcher : public FUObjectDeleteListener
+{
+private:
+	mutable std::shared_mutex m_mutex;
+	std::unordered_multimap<const void*, DataTableEntry*> m_entries = {};
+	std::unordered_map<const void*, UObject*> m_loading = {};
+	std::function<void(DataTableEntry&)> m_on_destroyed;
+
+public:
+	explicit DataTableWatcher(std::function<void(DataTableEntry&)> onDestroyed) : m_on_destroyed(std::move(onDestroyed)) {}
+
+	static auto IsLoading(const UObject* object) -> bool
+	{
+		return object->HasAnyFlags(static_cast<EObjectFlags>(RF_NeedLoad | RF_NeedPostLoad));
+	}
+
+	auto Watch(const UDataTable* table, DataTableEntry& entry) -> void
+	{
+		std::unique_lock lock(m_mutex);
+		m_entries.emplace(table, &entry);
+	}
+
+	auto AddLoading(UObject* table) -> void
+	{
+		std::unique_lock lock(m_mutex);
+		m_loading.emplace(table, table);
+	}
+
+	// Removes and returns the tables added with AddLoading that have finished loading
+	auto TakeLoaded() -> std::vector<UObject*>
+	{
+		std::vector<UObject*> loaded;
+		{
+			std::shared_lock lock(m_mutex);
+			if (m_loading.empty()) return loaded;
+		}
+
+		std::unique_lock lock(m_mutex);
+		for (auto it = m_loading.begin(); it != m_loading.end();)
+		{
+			if (IsLoading(it->second))
+			{
+				++it;
+				continue;
+			}
+			loaded.push_back(it->second);
+			it = m_loading.erase(it);
+		}
+		return loaded;
+	}
+
+	auto NotifyUObjectDeleted(const UObjectBase* object, [[maybe_unused]] int32 index) -> void override
+	{
+		// Called for every object the engine destroys, nearly none of them a table
+		{
+			std::shared_lock lock(m_mutex);
+			if (!m_entries.contains(object) && !m_loading.contains(object)) return;
+		}
+
+		std::vector<DataTableEntry*> destroyed;
+		{
+			std::unique_lock lock(m_mutex);
+			m_loading.erase(object);
+			auto [first, last] = m_entries.equal_range(object);
+			for (auto it = first; it != last; ++it) destroyed.push_back(it->second);
+			m_entries.erase(first, last);
+		}
+		for (DataTableEntry* entry : destroyed) m_on_destroyed(*entry);
+	}
+
+	auto OnUObjectArrayShutdown() -> void override
+	{
+		std::unique_lock lock(m_mutex);
+		m_entries.clear();
+		m_loading.clear();
+	}
+};
+
+// Collects the rows of one import into a row cache file (see RowCache.hpp). Every row write of
+// the import holds a reference, and the file is saved when the last of them has been applied.
+struct RowCacheRecording
+{
+	std::filesystem::path path;
+	uint64 inputHash = 0;
+	// Created with the first row, when the RowStruct is known
+	std::unique_ptr<RowCacheWriter> writer;
+	// Set when parsing or any row failed, the cache is not saved then
+	std::atomic<bool> failed = false;
+
+	~RowCacheRecording()
+	{
+		if (failed || !writer) return;
+
+		std::string error;
+		if (writer->Save(path, error))
+		{
+			Output::send<LogLevel::Default>(
+				STR("[TFWWorkbench] Saved {} rows to row cache {}\n"),
+				writer->RowCount(), path.wstring()
+			);
+		}
+		else
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Failed to save row cache: {}\n"), to_wstring(error));
+		}
+	}
+};
+
+// A row cache file whose rows are being replayed through the queue
+struct RowCacheReplay
+{
+	// Declared before `file` so a rebuilt cache is saved after the old one has been unmapped
+	std::shared_ptr<RowCacheRecording> rebuild;
+	std::filesystem::path path;
+	RowCacheFile file;
+
+	RowCacheReplay(const std::filesystem::path& cachePath, uint64 inputHash) : path(cachePath), file(cachePath, inputHash) {}
+};
+
+enum class RowWriteMode : uint8
+{
+	// Build the row from scratch, replacing any existing row
+	Replace,
+	// Write the fields into the existing row, fail when there is none
+	Patch,
+	// Patch the existing row, or build it from scratch when there is none
+	Upsert,
+	// Build the row as a copy of another row of the table, then write the fields over it
+	Clone,
+};
+
+// A row built into its own allocation by a RowBuildPool worker, waiting to be linked into its
+// table on the game thread. A row that is never committed is destroyed with its staging buffer.
+struct StagedRow
+{
+	RowLayout layout = {};
+	// DataTableEntry::tableEpoch when the row was staged. A row staged for a table destroyed
+	// since is not built, or is released without being committed.
+	uint32 tableEpoch = 0;
+	// Copied from a row image through the C API. Such a row isn't tied to a table epoch, it
+	// waits for its table like other writes and is checked against its RowStruct when committed.
+	bool image = false;
+	FName name = {};
+	// The finished row, nullptr until it is built and after it has been committed
+	uint8* row = nullptr;
+	// What building the row threw, rethrown when it is committed
+	std::exception_ptr exception = nullptr;
+	std::atomic<bool> done = false;
+
+	~StagedRow()
+	{
+		Release();
+	}
+
+	auto Release() -> void
+	{
+		if (row)
+		{
+			layout.rowStruct->DestroyStruct(row);
+			FMemory::Free(std::exchange(row, nullptr));
+		}
+	}
+};
+
+// A row write marshalled on the calling Lua state, waiting to be applied on the game thread
+struct PendingRowWrite
+{
+	DataTableEntry* entry = nullptr;
+	std::string rowName;
+	FieldValue fields;
+	// Set on the rows of an import that is being recorded into the row cache
+	std::shared_ptr<RowCacheRecording> recording = nullptr;
+	// Set on rows replayed from the row cache. Their fields are decoded from `cachedRow` when applied.
+	std::shared_ptr<RowCacheReplay> replay = nullptr;
+	const char* cachedRow = nullptr;
+	RowWriteMode mode = RowWriteMode::Replace;
+	// The row a Clone write copies
+	std::string sourceRow = {};
+	// Set when the row is being built off the game thread
+	std::shared_ptr<StagedRow> staged = nullptr;
+	// Set on Replace writes queued with incrementalWrites on
+	std::unique_ptr<RowInput> input = nullptr;
+};
+
+// Row writes from every Lua state, drained by on_update. Writes are heap allocated so one that
+// is being built by a RowBuildPool worker stays put while the queue grows.
+class RowWriteQueue
+{
+private:
+	mutable std::mutex m_mutex;
+	std::deque<std::unique_ptr<PendingRowWrite>> m_writes = {};
+	// Writes at the front that ForEachUnchecked has already visited
+	size_t m_checked = 0;
+
+public:
+	auto Push(std::unique_ptr<PendingRowWrite> write) -> void
+	{
+		std::lock_guard lock(m_mutex);
+		m_writes.push_back(std::move(write));
+	}
+
+	auto PushBatch(std::vector<std::unique_ptr<PendingRowWrite>>&& writes) -> void
+	{
+		std::lock_guard lock(m_mutex);
+		for (std::unique_ptr<PendingRowWrite>& write : writes)
+		{
+			m_writes.push_back(std::move(write));
+		}
+	}
+
+	// The oldest write, left in the queue. Only the thread that pops may hold on to it.
+	auto Front() const -> PendingRowWrite*
+	{
+		std::lock_guard lock(m_mutex);
+		return m_writes.empty() ? nullptr : m_writes.front().get();
+	}
+
+	auto Pop() -> std::unique_ptr<PendingRowWrite>
+	{
+		std::lock_guard lock(m_mutex);
+		if (m_writes.empty()) return nullptr;
+
+		std::unique_ptr<PendingRowWrite> write = std::move(m_writes.front());
+		m_writes.pop_front();
+		if (m_checked > 0) m_checked--;
+		return write;
+	}
+
+	// Calls `callable` for every queued write
+	template<typename Callable>
+	auto ForEach(Callable&& callable) const -> void
+	{
+		std::lock_guard lock(m_mutex);
+		for (const std::unique_ptr<PendingRowWrite>& write : m_writes)
+		{
+			callable(*write);
+		}
+	}
+
+	// Calls `callable` once for every write queued since the last call
+	template<typename Callable>
+	auto ForEachUnchecked(Callable&& callable) -> void
+	{
+		std::lock_guard lock(m_mutex);
+		for (size_t i = m_checked; i < m_writes.size(); i++)
+		{
+			callable(*m_writes[i]);
+		}
+		m_checked = m_writes.size();
+	}
+
+	auto Size() const -> size_t
+	{
+		std::lock_guard lock(m_mutex);
+		return m_writes.size();
+	}
+};
+
+// Worker threads that build rows into staging buffers (see StagedRow). While the game thread
+// waits for a row it runs queued jobs itself, so writes still make progress without workers.
+class RowBuildPool
+{
+private:
+	// Serializes SetThreadCount
+	std::mutex m_config_mutex;
+	std::mutex m_mutex;
+	// Signalled when a job is queued or the workers should exit
+	std::condition_variable m_work;
+	// Signalled when a job has finished
+	std::condition_variable m_finished;
+	std::deque<std::function<void()>> m_jobs = {};
+	std::vector<std::thread> m_threads = {};
+	size_t m_thread_count = std::max(1u, std::thread::hardware_concurrency()) - 1;
+	bool m_stopping = false;
+
+public:
+	~RowBuildPool()
+	{
+		StopThreads();
+	}
+
+	auto ThreadCount() -> size_t
+	{
+		std::lock_guard lock(m_mutex);
+		return m_thread_count;
+	}
+
+	// Takes effect for the next job. Queued jobs are kept, with no workers the game thread runs them.
+	auto SetThreadCount(size_t count) -> void
+	{
+		std::lock_guard configLock(m_config_mutex);
+		StopThreads();
+
+		std::lock_guard lock(m_mutex);
+		m_thread_count = count;
+		m_stopping = false;
+	}
+
+	auto Submit(std::function<void()> job) -> void
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			// Started with the first job so a mod that never writes never spawns threads
+			while (!m_stopping && m_threads.size() < m_thread_count)
+			{
+				m_threads.emplace_back([this] { WorkerLoop(); });
+			}
+			m_jobs.push_back(std::move(job));
+		}
+		m_work.notify_one();
+	}
+
+	// Waits until `done` is set, running queued jobs on the calling thread in the meantime.
+	// Returns false when `deadline` passes first.
+	auto WaitFor(const std::atomic<bool>& done, std::chrono::steady_clock::time_point deadline) -> bool
+	{
+		std::unique_lock lock(m_mutex);
+		while (!done.load(std::memory_order_acquire))
+		{
+			if (deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline)
+			{
+				return false;
+			}
+
+			if (!m_jobs.empty())
+			{
+				std::function<void()> job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+				lock.unlock();
+				job();
+				lock.lock();
+			}
+			else if (deadline == std::chrono::steady_clock::time_point::max())
+			{
+				m_finished.wait(lock);
+			}
+			else
+			{
+				m_finished.wait_until(lock, deadline);
+			}
+		}
+		return true;
+	}
+
+	// Lets the running jobs finish and joins the workers. Jobs still queued stay queued.
+	auto StopThreads() -> void
+	{
+		std::vector<std::thread> threads;
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+			threads = std::move(m_threads);
+			m_threads.clear();
+		}
+		m_work.notify_all();
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+private:
+	auto WorkerLoop() -> void
+	{
+		std::unique_lock lock(m_mutex);
+		while (true)
+		{
+			m_work.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+			if (m_stopping) return;
+
+			std::function<void()> job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+			lock.unlock();
+			job();
+			lock.lock();
+			m_finished.notify_all();
+		}
+	}
+};
+
+// One step from a row to the memory a row view shows: a struct field, or an element of a container
+struct RowViewStep
+{
+	// The struct field, or the array/map property the element belongs to
+	const PropertyWritePlan* plan = nullptr;
+	// Array index or sparse map index, -1 for a struct field
+	int32 index = -1;
+};
+
+// Userdata behind GetDataTableRow. It shows a row, or a struct, array or map inside one, and
+// converts a field only when it is indexed.
+struct RowView
+{
+	static constexpr const char* MetatableName = "TFWWorkbench.RowView";
+
+	DataTableEntry* entry = nullptr;
+	FName row = {};
+	// The struct viewed, or the FScriptArray/FScriptMap with the plan of its property
+	void* data = nullptr;
+	const StructWritePlan* structPlan = nullptr;
+	const PropertyWritePlan* containerPlan = nullptr;
+	// DataTableEntry::generation when `data` was looked up
+	uint64 generation = 0;
+	// DataTableEntry::tableEpoch when the view was made
+	uint32 tableEpoch = 0;
+	// Steps from the row to `data`, replayed when the table has been written since
+	std::vector<RowViewStep> path = {};
+};
+
+// One field write, as captured by the trace mode. Only ids are recorded, they are named when
+// flushed: table entries outlive their tables, and FNames outlive the properties they name.
+struct TraceRecord
+{
+	const DataTableEntry* table;
+	FName row;
+	FName field;
+	PropertyKind kind;
+	uint32 nanoseconds;
+};
+
+// Trace records, in one fixed-size ring per writing thread so the row-writing path appends
+// without taking a lock. The records are drained to the trace file from on_update, and a
+// thread's newest are dropped while its ring is full.
+class TraceRing
+{
+private:
+	static constexpr size_t Capacity = 1 << 14;
+
+	// Written by its thread only, and drained by Flush
+	struct Buffer
+	{
+		std::unique_ptr<TraceRecord[]> records = std::make_unique<TraceRecord[]>(Capacity);
+		std::atomic<size_t> head = 0;
+		std::atomic<size_t> tail = 0;
+		std::atomic<uint64> dropped = 0;
+	};
+
+	// This thread's buffer in the ring it last wrote to
+	struct ThreadState
+	{
+		uint64 owner = 0;
+		Buffer* buffer = nullptr;
+	};
+
+	static std::atomic<uint64> s_next_id;
+	static thread_local ThreadState t_state;
+
+	// Tells apart the instances of a mod that was unloaded and loaded again
+	uint64 m_id = s_next_id.fetch_add(1, std::memory_order_relaxed);
+	std::mutex m_mutex;
+	// Kept after their thread exits, until the ring is destroyed
+	std::vector<std::unique_ptr<Buffer>> m_buffers = {};
+
+	// Ids already named in the trace file, one set per id space (table, row, field)
+	std::unordered_set<uint64> m_named[3] = {};
+	std::string m_file_path = "TFWWorkbench.trace";
+
+	auto GetThreadBuffer() -> Buffer&
+	{
+		ThreadState& state = t_state;
+		if (state.owner != m_id)
+		{
+			auto buffer = std::make_unique<Buffer>();
+			state = { m_id, buffer.get() };
+
+			std::lock_guard lock(m_mutex);
+			m_buffers.push_back(std::move(buffer));
+		}
+		return *state.buffer;
+	}
+
+	static auto NameId(FName name) -> uint64
+	{
+		return (static_cast<uint64>(name.GetComparisonIndex()) << 32) | name.GetNumber();
+	}
+
+public:
+	auto SetFilePath(std::string_view filePath) -> void
+	{
+		std::lock_guard lock(m_mutex);
+		m_file_path = filePath;
+	}
+
+	auto Push(const TraceRecord& record) -> void
+	{
+		Buffer& buffer = GetThreadBuffer();
+		size_t tail = buffer.tail.load(std::memory_order_relaxed);
+		if (tail - buffer.head.load(std::memory_order_acquire) == Capacity)
+		{
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		buffer.records[tail % Capacity] = record;
+		buffer.tail.store(tail + 1, std::memory_order_release);
+	}
+
+	// File layout, little endian:
+	//   1 u8 space, u64 id, u16 length, UTF-8 name   names a table (0), row (1) or field (2) id once per session
+	//   2 u64 table, u64 row, u64 field, u8 kind, u32 ns
+	//   3 u64 count                          records lost to overflow since the last flush
+	// Only called from on_update.
+	auto Flush() -> void
+	{
+		std::vector<Buffer*> buffers;
+		std::string filePath;
+		{
+			std::lock_guard lock(m_mutex);
+			buffers.reserve(m_buffers.size());
+			for (const std::unique_ptr<Buffer>& buffer : m_buffers) buffers.push_back(buffer.get());
+			filePath = m_file_path;
+		}
+
+		std::vector<TraceRecord> records;
+		uint64 dropped = 0;
+		for (Buffer* buffer : buffers)
+		{
+			size_t head = buffer->head.load(std::memory_order_relaxed);
+			size_t tail = buffer->tail.load(std::memory_order_acquire);
+			for (size_t i = head; i != tail; i++)
+			{
+				records.push_back(buffer->records[i % Capacity]);
+			}
+			buffer->head.store(tail, std::memory_order_release);
+			dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+		}
+		if (records.empty() && dropped == 0) return;
+
+		std::ofstream file(filePath, std::ios::binary | std::ios::app);
+		if (!file)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Failed to open trace file: {}\n"), to_wstring(filePath));
+			return;
+		}
+
+		auto write = [&](const auto& value) {
+			file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		};
+		auto writeName = [&](uint8 space, uint64 id, auto&& getName) {
+			if (!m_named[space].insert(id).second) return;
+			std::string utf8 = getName();
+			write(uint8{ 1 });
+			write(space);
+			write(id);
+			write(static_cast<uint16>(utf8.size()));
+			file.write(utf8.data(), static_cast<std::streamsize>(utf8.size()));
+		};
+
+		for (const TraceRecord& record : records)
+		{
+			uint64 tableId = record.table ? static_cast<uint64>(record.table->handle) : 0;
+			uint64 rowId = NameId(record.row);
+			uint64 fieldId = NameId(record.field);
+			writeName(0, tableId, [&] { return record.table ? record.table->name : std::string{}; });
+			writeName(1, rowId, [&] { return to_string(record.row.ToString()); });
+			writeName(2, fieldId, [&] { return to_string(record.field.ToString()); });
+
+			write(uint8{ 2 });
+			write(tableId);
+			write(rowId);
+			write(fieldId);
+			write(static_cast<uint8>(record.kind));
+			write(record.nanoseconds);
+		}
+
+		if (dropped > 0)
+		{
+			write(uint8{ 3 });
+			write(dropped);
+		}
+	}
+};
+
+class TFWWorkbench : public RC::CppUserModBase
+{
+private:
+	// Static instance pointer for use in static lua callbacks
+	static TFWWorkbench* s_instance;
+
+	// Configured tables, indexed by handle - 1, and the name -> handle lookup
+	mutable std::shared_mutex m_data_tables_mutex;
+	std::vector<std::unique_ptr<DataTableEntry>> m_data_tables = {};
+	std::unordered_map<std::string, int32, StringHash, std::equal_to<>> m_data_table_handles = {};
+
+	// Guards table resolution and with it the write plans
+	std::mutex m_resolve_mutex;
+	std::unordered_map<UScriptStruct*, std::unique_ptr<StructWritePlan>> m_write_plans = {};
+	// Plans of structs that may have been destroyed with their table, see RetireWritePlans. Kept
+	// so the views and plans pointing at them don't dangle, but never looked up again.
+	std::vector<std::unique_ptr<StructWritePlan>> m_retired_plans = {};
+
+	// Resolution sweeps, see ResolveDataTables. A sweep is pending when tables were configured
+	// or destroyed since the last one. Tables it misses are looked for again after the retry
+	// interval, which doubles with every sweep that still misses some.
+	static constexpr std::chrono::steady_clock::duration SweepRetryMin = std::chrono::milliseconds(250);
+	static constexpr std::chrono::steady_clock::duration SweepRetryMax = std::chrono::seconds(8);
+	std::atomic<bool> m_sweep_pending = false;
+	std::atomic<std::chrono::steady_clock::rep> m_next_sweep = 0;
+	std::chrono::steady_clock::duration m_sweep_retry = SweepRetryMin;
+	WorkbenchStats::Timer m_sweeps = {};
+
+	// Writes to tables that weren't resolved when they were queued, flushed into m_row_writes in
+	// one batch when their table resolves. Tables are marked resolved under the mutex, so no
+	// write is parked after its table's writes were flushed.
+	// The writes parked for one table, oldest first. Writes taken off the queue because their
+	// table was destroyed are older than any parked since, and go in front of those.
+	struct ParkedWrites
+	{
+		std::vector<std::unique_ptr<PendingRowWrite>> writes = {};
+		size_t requeued = 0;
+	};
+	std::mutex m_parked_mutex;
+	std::unordered_map<const DataTableEntry*, ParkedWrites> m_parked_writes = {};
+	std::atomic<size_t> m_parked_count = 0;
+	DataTableWatcher m_table_watcher{ [this](DataTableEntry& entry) { ForgetDataTable(entry); } };
+
+	// Row being written on this thread, for trace records
+	struct TraceContext
+	{
+		const DataTableEntry* table = nullptr;
+		FName row = {};
+	};
+	static thread_local TraceContext t_trace_context;
+
+	NameCache m_name_cache = {};
+	TextCache m_text_cache = {};
+	ObjectCache m_object_cache = {};
+	SoftPathCache m_soft_path_cache = {};
+
+	RowWriteQueue m_row_writes = {};
+	std::atomic<int64> m_frame_budget_us = 1000;
+	// Whether Replace writes record their input, see ConfigureWorkbench
+	std::atomic<bool> m_incremental_writes = false;
+	// After the queue, so the workers are joined before the writes they build are destroyed
+	RowBuildPool m_build_pool = {};
+
+	// Row cache settings, see ConfigureWorkbench
+	mutable std::mutex m_row_cache_mutex;
+	bool m_row_cache_enabled = true;
+	std::filesystem::path m_row_cache_dir = "TFWWorkbench.rowcache";
+
+	TraceRing m_trace = {};
+
+	// Call trace capture, see ConfigureWorkbench's captureFile. m_capture_writes is set by every
+	// captured write and cleared by the next frame's Update record.
+	CallTraceWriter m_capture = {};
+	std::atomic<bool> m_capturing = false;
+	std::atomic<bool> m_capture_writes = false;
+
+	WorkbenchStats m_stats = {};
+	// Where the stats are written as JSON when the mod unloads, empty for nowhere
+	mutable std::mutex m_stats_file_mutex;
+	std::filesystem::path m_stats_file = {};
+
+public:
+	static std::atomic<bool> s_verbose_logging;
+	static std::atomic<bool> s_tracing;
+
+	TFWWorkbench() : CppUserModBase()
+	{
+		ModName = STR("TFWWorkbench");
+		ModVersion = STR("0.1");
+		ModDescription = STR("Manage items, vendors, crafting recipes, and more for TFW");
+		ModAuthors = STR("terraru");
+
+		s_instance = this;
+	}
+
+	~TFWWorkbench() override
+	{
+		// The workers use the caches through s_instance
+		m_build_pool.StopThreads();
+		WriteStatsFile();
+		m_capture.Close();
+		// Imports into a table that never loaded are incomplete, their row caches aren't saved
+		for (auto& [entry, parked] : m_parked_writes)
+		{
+			for (std::unique_ptr<PendingRowWrite>& write : parked.writes)
+			{
+				if (write->recording) write->recording->failed = true;
+			}
+		}
+		UObjectArray::RemoveUObjectDeleteListener(&m_object_cache);
+		UObjectArray::RemoveUObjectDeleteListener(&m_table_watcher);
+		s_instance = nullptr;
+	}
+
+	auto on_update() -> void override
+	{
+		if (m_capturing.load(std::memory_order_relaxed) && m_capture_writes.exchange(false, std::memory_order_relaxed))
+		{
+			CallTraceRecord record(CallRecordKind::Update);
+			m_capture.Append(record);
+		}
+
+		ResolveWaitingTables();
+		ApplyPendingRowWrites();
+
+#if TFWWORKBENCH_TRACING
+		m_trace.Flush();
+#endif
+	}
+
+	auto on_unreal_init() -> void override
+	{
+		UObjectArray::AddUObjectDeleteListener(&m_object_cache);
+		UObjectArray::AddUObjectDeleteListener(&m_table_watcher);
+		Hook::RegisterStaticConstructObjectPostCallback(&TFWWorkbench::OnObjectConstructed);
+	}
+
+	auto on_lua_start([[maybe_unused]] LuaMadeSimple::Lua& lua,
+		LuaMadeSimple::Lua& main_lua,
+		LuaMadeSimple::Lua& async_lua,
+		LuaMadeSimple::Lua* hook_lua) -> void override
+	{
+		main_lua.register_function("AddDataTableRow", &TFWWorkbench::Lua_AddDataTableRow);
+		main_lua.register_function("AddDataTableRows", &TFWWorkbench::Lua_AddDataTableRows);
+		main_lua.register_function("PatchDataTableRow", &TFWWorkbench::Lua_PatchDataTableRow);
+		main_lua.register_function("CloneDataTableRow", &TFWWorkbench::Lua_CloneDataTableRow);
+		// The readers walk table memory that on_update writes, so they stay off the other states
+		main_lua.register_function("GetDataTableRow", &TFWWorkbench::Lua_GetDataTableRow);
+		main_lua.register_function("FindDataTableRows", &TFWWorkbench::Lua_FindDataTableRows);
+		main_lua.register_function("ImportDataTableRows", &TFWWorkbench::Lua_ImportDataTableRows);
+		main_lua.register_function("ConfigureDataTables", &TFWWorkbench::Lua_ConfigureDataTables);
+		main_lua.register_function("ConfigureWorkbench", &TFWWorkbench::Lua_ConfigureWorkbench);
+		main_lua.register_function("GetWorkbenchStats", &TFWWorkbench::Lua_GetWorkbenchStats);
+		main_lua.register_function("GetDataTableRowChanges", &TFWWorkbench::Lua_GetDataTableRowChanges);
+
+		async_lua.register_function("AddDataTableRow", &TFWWorkbench::Lua_AddDataTableRow);
+		async_lua.register_function("AddDataTableRows", &TFWWorkbench::Lua_AddDataTableRows);
+		async_lua.register_function("PatchDataTableRow", &TFWWorkbench::Lua_PatchDataTableRow);
+		async_lua.register_function("CloneDataTableRow", &TFWWorkbench::Lua_CloneDataTableRow);
+		async_lua.register_function("ImportDataTableRows", &TFWWorkbench::Lua_ImportDataTableRows);
+		async_lua.register_function("ConfigureDataTables", &TFWWorkbench::Lua_ConfigureDataTables);
+		async_lua.register_function("ConfigureWorkbench", &TFWWorkbench::Lua_ConfigureWorkbench);
+		async_lua.register_function("GetWorkbenchStats", &TFWWorkbench::Lua_GetWorkbenchStats);
+		async_lua.register_function("GetDataTableRowChanges", &TFWWorkbench::Lua_GetDataTableRowChanges);
+
+		if (hook_lua)
+		{
+			hook_lua->register_function("AddDataTableRow", &TFWWorkbench::Lua_AddDataTableRow);
+			hook_lua->register_function("AddDataTableRows", &TFWWorkbench::Lua_AddDataTableRows);
+			hook_lua->register_function("PatchDataTableRow", &TFWWorkbench::Lua_PatchDataTableRow);
+			hook_lua->register_function("CloneDataTableRow", &TFWWorkbench::Lua_CloneDataTableRow);
+			hook_lua->register_function("ImportDataTableRows", &TFWWorkbench::Lua_ImportDataTableRows);
+			hook_lua->register_function("ConfigureDataTables", &TFWWorkbench::Lua_ConfigureDataTables);
+			hook_lua->register_function("ConfigureWorkbench", &TFWWorkbench::Lua_ConfigureWorkbench);
+			hook_lua->register_function("GetWorkbenchStats", &TFWWorkbench::Lua_GetWorkbenchStats);
+			hook_lua->register_function("GetDataTableRowChanges", &TFWWorkbench::Lua_GetDataTableRowChanges);
+		}
+
+		Output::send<LogLevel::Default>(STR("[TFWWorkbench] Registered Lua functions for mod\n"));
+	}
+
+	// Behind the C API in TFWWorkbenchApi.h, see the exports at the end of this file. Errors
+	// are logged like the Lua API's and returned as TFW_ERROR_* results.
+	static auto Api_ConfigureTable(const char* name, const char* path) -> int32
+	{
+		if (!s_instance) return TFW_ERROR_NOT_LOADED;
+		if (!name || !path || !*name || !*path)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Parameters cannot be null or empty\n"));
+			return TFW_ERROR_INVALID_ARGUMENT;
+		}
+
+		return s_instance->ConfigureDataTable(name, to_wstring(path));
+	}
+
+	static auto Api_FindTable(const char* name) -> int32
+	{
+		if (!s_instance) return TFW_ERROR_NOT_LOADED;
+		if (!name) return TFW_ERROR_INVALID_ARGUMENT;
+
+		DataTableEntry* entry = s_instance->FindDataTable(std::string_view(name));
+		return entry ? entry->handle : TFW_ERROR_UNKNOWN_TABLE;
+	}
+
+	static auto Api_WriteRows(int32 table, const TFWRow* rows, size_t count, int32 mode) -> int32
+	{
+		if (!s_instance) return TFW_ERROR_NOT_LOADED;
+
+		DataTableEntry* entry = s_instance->FindDataTable(table);
+		if (!entry)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Invalid DataTable handle: {}\n"), table);
+			return TFW_ERROR_UNKNOWN_TABLE;
+		}
+		if ((!rows && count > 0) || mode < TFW_WRITE_REPLACE || mode > TFW_WRITE_UPSERT)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Invalid parameters for TFWWorkbench_WriteRows\n"));
+			return TFW_ERROR_INVALID_ARGUMENT;
+		}
+
+		auto writeMode = mode == TFW_WRITE_PATCH ? RowWriteMode::Patch
+			: mode == TFW_WRITE_UPSERT ? RowWriteMode::Upsert
+			: RowWriteMode::Replace;
+
+		try
+		{
+			std::vector<PendingRowWrite> writes;
+			writes.reserve(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				const TFWRow& row = rows[i];
+				if (!row.name || !*row.name || (!row.fields && row.fieldCount > 0))
+				{
+					Output::send<LogLevel::Error>(STR("[TFWWorkbench] Row {} passed to TFWWorkbench_WriteRows has no name or fields\n"), i);
+					return TFW_ERROR_INVALID_ARGUMENT;
+				}
+
+				TFWValue fields = {};
+				fields.type = TFW_VALUE_TABLE;
+				fields.as.table.entries = row.fields;
+				fields.as.table.count = row.fieldCount;
+				writes.push_back({ entry, row.name, FieldValueFromApi(fields), nullptr, nullptr, nullptr, writeMode });
+			}
+
+			s_instance->QueueRowWrites(std::move(writes));
+			return TFW_OK;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Exception: {}\n"), to_wstring(e.what()));
+			return TFW_ERROR_EXCEPTION;
+		}
+	}
+
+	static auto Api_AddRowImages(int32 table,
+		const void* rowStruct,
+		const char* const* rowNames,
+		const void* images,
+		size_t imageSize,
+		size_t count) -> int32
+	{
+		if (!s_instance) return TFW_ERROR_NOT_LOADED;
+
+		DataTableEntry* entry = s_instance->FindDataTable(table);
+		if (!entry)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Invalid DataTable handle: {}\n"), table);
+			return TFW_ERROR_UNKNOWN_TABLE;
+		}
+		if (count > 0 && (!rowNames || !images))
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Invalid parameters for TFWWorkbench_AddRowImages\n"));
+			return TFW_ERROR_INVALID_ARGUMENT;
+		}
+
+		// Only looked at here, resolving and writing is left to the game thread like for other writes
+		UScriptStruct* tableStruct = nullptr;
+		{
+			std::lock_guard lock(s_instance->m_resolve_mutex);
+			if (entry->resolved.load(std::memory_order_acquire)) tableStruct = entry->rowStruct;
+		}
+		auto* imageStruct = rowStruct ? static_cast<UScriptStruct*>(const_cast<void*>(rowStruct)) : tableStruct;
+		if (!imageStruct)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] '{}' isn't loaded, its row images need their RowStruct to be copied\n"),
+				to_wstring(entry->name)
+			);
+			return TFW_ERROR_UNRESOLVED_TABLE;
+		}
+		if ((tableStruct && imageStruct != tableStruct) || imageSize != static_cast<size_t>(imageStruct->GetStructureSize()))
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Row images of {} bytes don't match the RowStruct of '{}'\n"),
+				imageSize, to_wstring(entry->name)
+			);
+			return TFW_ERROR_STRUCT_MISMATCH;
+		}
+
+		try
+		{
+			// Each copy becomes a row that is already built, and is only linked in on the game thread.
+			// Copies for a table that isn't loaded yet wait for it like any other write.
+			std::vector<PendingRowWrite> writes;
+			writes.reserve(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				if (!rowNames[i] || !*rowNames[i])
+				{
+					Output::send<LogLevel::Error>(STR("[TFWWorkbench] Row {} passed to TFWWorkbench_AddRowImages has no name\n"), i);
+					return TFW_ERROR_INVALID_ARGUMENT;
+				}
+
+				auto staged = std::make_shared<StagedRow>();
+				staged->layout.rowStruct = imageStruct;
+				staged->image = true;
+				staged->name = s_instance->m_name_cache.ToName(rowNames[i]);
+				staged->row = static_cast<uint8*>(FMemory::Malloc(imageStruct->GetStructureSize(), imageStruct->GetMinAlignment()));
+				if (!staged->row)
+				{
+					Output::send<LogLevel::Error>(STR("[TFWWorkbench] Failed to allocate memory for new row\n"));
+					return TFW_ERROR_EXCEPTION;
+				}
+				imageStruct->InitializeStruct(staged->row);
+				imageStruct->CopyScriptStruct(staged->row, static_cast<const uint8*>(images) + i * imageSize);
+				staged->done = true;
+
+				PendingRowWrite& write = writes.emplace_back();
+				write.entry = entry;
+				write.rowName = rowNames[i];
+				write.fields = FieldValue::make_table();
+				write.staged = std::move(staged);
+			}
+
+			s_instance->QueueRowWrites(std::move(writes));
+			return TFW_OK;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Exception: {}\n"), to_wstring(e.what()));
+			return TFW_ERROR_EXCEPTION;
+		}
+	}
+
+private:
+	auto FindDataTable(std::string_view tableName) const -> DataTableEntry*
+	{
+		std::shared_lock lock(m_data_tables_mutex);
+		if (auto it = m_data_table_handles.find(tableName); it != m_data_table_handles.end())
+		{
+			return m_data_tables[it->second - 1].get();
+		}
+		return nullptr;
+	}
+
+	auto FindDataTable(int64 handle) const -> DataTableEntry*
+	{
+		std::shared_lock lock(m_data_tables_mutex);
+		if (handle < 1 || handle > static_cast<int64>(m_data_tables.size()))
+		{
+			return nullptr;
+		}
+		return m_data_tables[handle - 1].get();
+	}
+
+	// Whether the entry's table is resolved and has a RowStruct. Unresolved tables are looked
+	// for by a sweep when one is due. Writes resolve on the game thread and row views on their
+	// Lua state, so the sweeps are serialized.
+	auto ResolveDataTable(DataTableEntry& entry) -> bool
+	{
+		if (!entry.resolved.load(std::memory_order_acquire))
+		{
+			ResolveDataTables();
+			if (!entry.resolved.load(std::memory_order_acquire)) return false;
+		}
+
+		return entry.table && entry.rowStruct;
+	}
+
+	auto SweepDue() const -> bool
+	{
+		return m_sweep_pending.load(std::memory_order_acquire)
+			|| std::chrono::steady_clock::now().time_since_epoch().count() >= m_next_sweep.load(std::memory_order_relaxed);
+	}
+
+	// Object name of a configured path, the part after the last '.', ':' or '/'
+	static auto ObjectNameOf(StringViewType path) -> StringViewType
+	{
+		size_t separator = path.find_last_of(STR("./:"));
+		return separator == StringViewType::npos ? path : path.substr(separator + 1);
+	}
+
+	// The unresolved tables, and those of them whose object name exists by its FName id. A path
+	// may be configured under several names, which all resolve to its table.
+	struct WantedTables
+	{
+		std::vector<DataTableEntry*> unresolved = {};
+		std::unordered_map<uint64, std::vector<DataTableEntry*>> byName = {};
+		// Tables in byName that haven't been found yet
+		size_t remaining = 0;
+	};
+
+	// Called under m_resolve_mutex
+	auto CollectWantedTables() -> WantedTables
+	{
+		WantedTables wanted;
+		std::shared_lock lock(m_data_tables_mutex);
+		for (const auto& entry : m_data_tables)
+		{
+			if (entry->resolved.load(std::memory_order_relaxed)) continue;
+
+			wanted.unresolved.push_back(entry.get());
+			if (entry->objectName.IsNone())
+			{
+				entry->objectName = FName(ObjectNameOf(entry->path), FNAME_Find);
+			}
+			if (!entry->objectName.IsNone())
+			{
+				wanted.byName[GetNameId(entry->objectName)].push_back(entry.get());
+				wanted.remaining++;
+			}
+		}
+		return wanted;
+	}
+
+	// Matches `object` against the wanted tables by name first, so only the candidates' paths
+	// are compared. A table that is still being loaded is left to the watcher, which hands it
+	// back once its rows are in.
+	auto MatchWantedTable(UObject* object, WantedTables& wanted) -> void
+	{
+		auto it = wanted.byName.find(GetNameId(object->GetNamePrivate()));
+		if (it == wanted.byName.end() || !object->IsA<UDataTable>()) return;
+
+		StringType path = object->GetPathName();
+		for (DataTableEntry* entry : it->second)
+		{
+			if (entry->table || entry->path != path) continue;
+			if (DataTableWatcher::IsLoading(object))
+			{
+				m_table_watcher.AddLoading(object);
+				return;
+			}
+			entry->table = static_cast<UDataTable*>(object);
+			wanted.remaining--;
+		}
+	}
+
+	// Sets up the wanted tables that were found, and returns how many are still missing. Called
+	// under m_resolve_mutex.
+	auto ResolveWantedTables(const WantedTables& wanted, bool reportMissing) -> size_t
+	{
+		size_t missing = 0;
+		for (DataTableEntry* entry : wanted.unresolved)
+		{
+			if (entry->table)
+			{
+				ResolveFoundTable(*entry);
+				continue;
+			}
+
+			missing++;
+			if (reportMissing && !entry->reportedMissing)
+			{
+				Output::send<LogLevel::Warning>(
+					STR("[TFWWorkbench] DataTable {} is not loaded: {}\n"),
+					to_wstring(entry->name), entry->path
+				);
+				entry->reportedMissing = true;
+			}
+		}
+		return missing;
+	}
+
+	// Looks for every unresolved table with one pass over the object array, instead of a
+	// StaticFindObject per table, when a sweep is due. A table whose object name isn't even a
+	// name yet can't be loaded, and costs nothing to miss.
+	auto ResolveDataTables() -> void
+	{
+		if (!SweepDue()) return;
+
+		std::lock_guard lock(m_resolve_mutex);
+		if (!SweepDue()) return;
+		bool pending = m_sweep_pending.exchange(false, std::memory_order_acq_rel);
+		auto start = std::chrono::steady_clock::now();
+
+		WantedTables wanted = CollectWantedTables();
+		if (wanted.unresolved.empty()) return;
+
+		// Ends as soon as every table with a name was found
+		if (wanted.remaining > 0)
+		{
+			UObjectGlobals::ForEachUObject([&](UObject* object, int32, int32) {
+				MatchWantedTable(object, wanted);
+				return wanted.remaining > 0 ? LoopAction::Continue : LoopAction::Break;
+			});
+		}
+		size_t missing = ResolveWantedTables(wanted, true);
+
+		auto end = std::chrono::steady_clock::now();
+		m_sweep_retry = pending || missing == 0 ? SweepRetryMin : std::min(m_sweep_retry * 2, SweepRetryMax);
+		m_next_sweep.store((end + m_sweep_retry).time_since_epoch().count(), std::memory_order_relaxed);
+
+		if (WorkbenchStats::Enabled())
+		{
+			auto elapsed = static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+			m_sweeps.Add(1, elapsed, elapsed);
+		}
+		TFW_LOG_VERBOSE(
+			STR("[TFWWorkbench] Resolution sweep found {} of {} DataTables\n"),
+			wanted.unresolved.size() - missing, wanted.unresolved.size()
+		);
+	}
+
+	// Resolves the tables writes are parked for, on the game thread before the frame's writes:
+	// the DataTables constructed since writes started waiting that have finished loading, and
+	// whatever a sweep finds when one is due.
+	auto ResolveWaitingTables() -> void
+	{
+		if (m_parked_count.load(std::memory_order_acquire) == 0) return;
+
+		std::vector<UObject*> loaded = m_table_watcher.TakeLoaded();
+		if (!loaded.empty())
+		{
+			std::lock_guard lock(m_resolve_mutex);
+			WantedTables wanted = CollectWantedTables();
+			for (UObject* object : loaded)
+			{
+				if (wanted.remaining == 0) break;
+				MatchWantedTable(object, wanted);
+			}
+			ResolveWantedTables(wanted, false);
+		}
+
+		ResolveDataTables();
+	}
+
+	// Called by UE4SS for every object it constructs. While writes are parked, the DataTables
+	// among them go to the watcher, so their writes are flushed once they have loaded instead of
+	// waiting for the next sweep.
+	static auto OnObjectConstructed(const FStaticConstructObjectParameters&, UObject* object) -> UObject*
+	{
+		if (s_instance && object && s_instance->m_parked_count.load(std::memory_order_relaxed) > 0 && object->IsA<UDataTable>())
+		{
+			s_instance->m_table_watcher.AddLoading(object);
+		}
+		return object;
+	}
+
+	// Sets up a table a sweep found: its RowStruct and write plan. Called under m_resolve_mutex.
+	auto ResolveFoundTable(DataTableEntry& entry) -> void
+	{
+		TFW_LOG_VERBOSE(
+			STR("[TFWWorkbench] Caching DataTable: {}\n"),
+			to_wstring(entry.name)
+		);
+		auto start = std::chrono::steady_clock::now();
+		entry.rowStruct = entry.table->GetRowStruct();
+		entry.plan = entry.rowStruct ? GetWritePlan(entry.rowStruct) : nullptr;
+		std::unordered_set<const StructWritePlan*> visited;
+		entry.offThreadBuild = entry.plan && CanBuildOffThread(*entry.plan, visited);
+		if (WorkbenchStats::Enabled())
+		{
+			auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			entry.stats.resolveNanoseconds.fetch_add(static_cast<uint64>(elapsed.count()), std::memory_order_relaxed);
+		}
+
+		// Reported once, later writes to the table fail quietly
+		if (!entry.rowStruct)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] DataTable RowStruct not found\n"));
+		}
+		m_table_watcher.Watch(entry.table, entry);
+		entry.reportedMissing = false;
+		if (m_capturing.load(std::memory_order_relaxed)) CaptureTableLayout(entry);
+
+		// Writes are parked until the table resolves, under the same lock, so none can be left behind
+		std::vector<std::unique_ptr<PendingRowWrite>> parked;
+		{
+			std::lock_guard lock(m_parked_mutex);
+			entry.resolved.store(true, std::memory_order_release);
+			if (auto it = m_parked_writes.find(&entry); it != m_parked_writes.end())
+			{
+				parked = std::move(it->second.writes);
+				m_parked_writes.erase(it);
+				m_parked_count.fetch_sub(parked.size(), std::memory_order_release);
+			}
+			if (!parked.empty())
+			{
+				TFW_LOG_VERBOSE(
+					STR("[TFWWorkbench] Flushing {} writes parked for DataTable {}\n"),
+					parked.size(), to_wstring(entry.name)
+				);
+				for (std::unique_ptr<PendingRowWrite>& write : parked) StageRowWrite(*write);
+				m_row_writes.PushBatch(std::move(parked));
+			}
+		}
+	}
+
+	// Resets an entry whose table was destroyed, so the next sweep looks for it again. Rows the
+	// entry kept track of went with the table. The engine destroys objects on the game thread,
+	// which is where that row state is used.
+	auto ForgetDataTable(DataTableEntry& entry) -> void
+	{
+		TFW_LOG_VERBOSE(STR("[TFWWorkbench] DataTable {} was destroyed\n"), to_wstring(entry.name));
+		// Rows staged from here on are skipped by the workers, those being built use the
+		// table's struct and plans, which may go with it
+		entry.tableEpoch.fetch_add(1, std::memory_order_acq_rel);
+		ReleaseStagedRows(entry);
+		{
+			std::lock_guard lock(m_resolve_mutex);
+			RetireWritePlans(entry);
+			entry.resolved.store(false, std::memory_order_release);
+			entry.table = nullptr;
+			entry.rowStruct = nullptr;
+			entry.plan = nullptr;
+			entry.offThreadBuild = false;
+		}
+		entry.generation.fetch_add(1, std::memory_order_release);
+		{
+			std::lock_guard lock(entry.inputsMutex);
+			entry.inputs.clear();
+		}
+		{
+			std::unique_lock lock(entry.indexesMutex);
+			entry.indexes.clear();
+			entry.indexed.store(false, std::memory_order_relaxed);
+		}
+		m_sweep_pending.store(true, std::memory_order_release);
+	}
+
+	// Waits for the rows staged for `entry` to be built, then releases them while their struct is
+	// still there. Their writes fail when they are applied.
+	auto ReleaseStagedRows(const DataTableEntry& entry) -> void
+	{
+		std::vector<std::shared_ptr<StagedRow>> staged;
+		m_row_writes.ForEach([&](const PendingRowWrite& write) {
+			if (write.entry == &entry && write.staged && !write.staged->image) staged.push_back(write.staged);
+		});
+		for (const std::shared_ptr<StagedRow>& row : staged)
+		{
+			m_build_pool.WaitFor(row->done, std::chrono::steady_clock::time_point::max());
+			row->Release();
+		}
+	}
+
+	// Row cache file for importing `filePath` into `entry`, or an empty path when the cache is off.
+	// There is one file per table and import file, so a changed import replaces its old cache.
+	auto GetRowCachePath(const DataTableEntry& entry, const std::filesystem::path& filePath) const -> std::filesystem::path
+	{
+		std::lock_guard lock(m_row_cache_mutex);
+		if (!m_row_cache_enabled) return {};
+
+		std::u8string source = filePath.lexically_normal().generic_u8string();
+		char sourceHash[16];
+		auto [end, error] = std::to_chars(sourceHash, sourceHash + sizeof(sourceHash), HashBytes(source.data(), source.size()), 16);
+
+		std::string fileName = entry.name;
+		for (char& c : fileName)
+		{
+			if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+		}
+		fileName.append("-").append(sourceHash, end).append(".rowcache");
+		return m_row_cache_dir / fileName;
+	}
+
+	// Consumes the table argument of a row API call, which is either a handle returned by
+	// ConfigureDataTables or the configured table name
+	static auto GetDataTableArg(const LuaMadeSimple::Lua& lua) -> DataTableEntry*
+	{
+		DataTableEntry* entry = nullptr;
+		if (lua.is_integer())
+		{
+			int64 handle = lua.get_integer();
+			entry = s_instance->FindDataTable(handle);
+			if (!entry)
+			{
+				Output::send<LogLevel::Error>(STR("[TFWWorkbench] Invalid DataTable handle: {}\n"), handle);
+			}
+		}
+		else if (lua.is_string())
+		{
+			std::string_view tableName = lua.get_string();
+			entry = s_instance->FindDataTable(tableName);
+			if (!entry)
+			{
+				Output::send<LogLevel::Error>(STR("[TFWWorkbench] DataTable not configured: {}\n"), to_wstring(tableName));
+			}
+		}
+		else
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Invalid parameters. Expected a DataTable name or handle\n"));
+		}
+		return entry;
+	}
+
+	// Takes the plans that only `entry` uses out of m_write_plans, since its RowStruct and the
+	// structs in it may be destroyed along with its table. A struct allocated at the same address
+	// afterwards gets a plan of its own. Called under m_resolve_mutex.
+	auto RetireWritePlans(const DataTableEntry& entry) -> void
+	{
+		if (!entry.plan) return;
+
+		std::unordered_set<const StructWritePlan*> plans;
+		CollectWritePlans(*entry.plan, plans);
+		std::unordered_set<const StructWritePlan*> shared;
+		{
+			std::shared_lock lock(m_data_tables_mutex);
+			for (const auto& other : m_data_tables)
+			{
+				if (other.get() != &entry && other->plan) CollectWritePlans(*other->plan, shared);
+			}
+		}
+
+		for (auto it = m_write_plans.begin(); it != m_write_plans.end();)
+		{
+			if (plans.contains(it->second.get()) && !shared.contains(it->second.get()))
+			{
+				m_retired_plans.push_back(std::move(it->second));
+				it = m_write_plans.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	// Adds `plan` and the plans of the structs nested in it to `plans`
+	static auto CollectWritePlans(const StructWritePlan& plan, std::unordered_set<const StructWritePlan*>& plans) -> void
+	{
+		if (!plans.insert(&plan).second) return;
+		for (const PropertyWritePlan* field : plan.fieldOrder)
+		{
+			CollectWritePlans(*field, plans);
+		}
+	}
+
+	static auto CollectWritePlans(const PropertyWritePlan& plan, std::unordered_set<const StructWritePlan*>& plans) -> void
+	{
+		if (plan.structPlan) CollectWritePlans(*plan.structPlan, plans);
+		if (plan.inner) CollectWritePlans(*plan.inner, plans);
+		if (plan.value) CollectWritePlans(*plan.value, plans);
+	}
+
+	// Returns the write plan for `scriptStruct`, compiling it the first time the struct is seen.
+	static auto GetWritePlan(UScriptStruct* scriptStruct) -> const StructWritePlan*
+	{
+		auto& plans = s_instance->m_write_plans;
+		if (auto it = plans.find(scriptStruct); it != plans.end())
+		{
+			return it->second.get();
+		}
+
+		TFW_LOG_VERBOSE(
+			STR("[TFWWorkbench] Compiling write plan for struct: {}\n"),
+			scriptStruct->GetName()
+		);
+
+		// Registered before the fields are compiled so self-referencing structs resolve to this plan
+		auto* plan = plans.emplace(scriptStruct, std::make_unique<StructWritePlan>()).first->second.get();
+		plan->scriptStruct = scriptStruct;
+
+		for (FProperty* property : scriptStruct->ForEachPropertyInChain())
+		{
+			PropertyWritePlan fieldPlan = CompilePropertyPlan(property);
+			auto [it, inserted] = plan->fields.emplace(to_string(fieldPlan.name), std::move(fieldPlan));
+			if (inserted) plan->fieldOrder.push_back(&it->second);
+		}
+
+		plan->trivial = true;
+		uint64 layoutHash = HashValue(scriptStruct->GetStructureSize(), HashSeed);
+		for (const PropertyWritePlan* field : plan->fieldOrder)
+		{
+			layoutHash = HashBytes(field->name.data(), field->name.size() * sizeof(CharType), layoutHash);
+			layoutHash = HashValue(field->kind, layoutHash);
+			layoutHash = HashValue(field->offset, layoutHash);
+			layoutHash = HashValue(field->property->GetSize(), layoutHash);
+			if (field->kind == PropertyKind::Struct)
+			{
+				layoutHash = HashValue(field->structPlan->layoutHash, layoutHash);
+			}
+
+			if (field->trivial) plan->trivialFields.push_back(field);
+			else plan->trivial = false;
+		}
+		plan->layoutHash = layoutHash;
+
+		return plan;
+	}
+
+	// Whether every value of `plan` can be written off the game thread. Object references are
+	// looked up with StaticFindObject, which only the game thread may call.
+	static auto CanBuildOffThread(const StructWritePlan& plan, std::unordered_set<const StructWritePlan*>& visited) -> bool
+	{
+		if (!visited.insert(&plan).second) return true;
+
+		for (const PropertyWritePlan* field : plan.fieldOrder)
+		{
+			if (!CanBuildOffThread(*field, visited)) return false;
+		}
+		return true;
+	}
+
+	static auto CanBuildOffThread(const PropertyWritePlan& plan, std::unordered_set<const StructWritePlan*>& visited) -> bool
+	{
+		if (plan.kind == PropertyKind::Object) return false;
+		if (plan.structPlan && !CanBuildOffThread(*plan.structPlan, visited)) return false;
+		if (plan.inner && !CanBuildOffThread(*plan.inner, visited)) return false;
+		if (plan.value && !CanBuildOffThread(*plan.value, visited)) return false;
+		return true;
+	}
+
+	// Fills in `plan` when `property` is one of the numeric types in NumericCodecs
+	template<typename... Codecs>
+	static auto CompileNumericPlan(FProperty* property, PropertyWritePlan& plan, std::tuple<Codecs...>*) -> bool
+	{
+		auto compile = [&]<typename Codec>(Codec*) -> bool {
+			if (!CastField<typename Codec::Property>(property)) return false;
+
+			plan.kind = Codec::kind;
+			plan.trivial = true;
+			plan.setter = &SetNumericValue<typename Codec::Value>;
+			plan.fill = &FillNumericArray<typename Codec::Value>;
+			return true;
+		};
+		return (compile(static_cast<Codecs*>(nullptr)) || ...);
+	}
+
+	// Picks the setter for `property` once, so writing a value is a single indirect call.
+	static auto CompilePropertyPlan(FProperty* property) -> PropertyWritePlan
+	{
+		PropertyWritePlan plan{};
+		plan.property = property;
+		plan.offset = property->GetOffset_Internal();
+		plan.name = property->GetName();
+		plan.fname = FName(plan.name.c_str(), FNAME_Add);
+
+		if (CompileNumericPlan(property, plan, static_cast<NumericCodecs*>(nullptr)))
+		{
+			return plan;
+		}
+
+		if (CastField<FTextProperty>(property))
+		{
+			plan.kind = PropertyKind::Text;
+			plan.setter = &SetTextValue;
+		}
+		else if (CastField<FStrProperty>(property))
+		{
+			plan.kind = PropertyKind::Str;
+			plan.setter = &SetStrValue;
+		}
+		else if (CastField<FNameProperty>(property))
+		{
+			plan.kind = PropertyKind::Name;
+			plan.setter = &SetNameValue;
+		}
+		else if (CastField<FBoolProperty>(property))
+		{
+			plan.kind = PropertyKind::Bool;
+			plan.trivial = true;
+			plan.setter = &SetBoolValue;
+		}
+		else if (CastField<FSoftObjectProperty>(property))
+		{
+			plan.kind = PropertyKind::SoftObject;
+			plan.setter = &SetSoftObjectValue;
+		}
+		else if (CastField<FEnumProperty>(property))
+		{
+			plan.kind = PropertyKind::Enum;
+			plan.trivial = true;
+			plan.setter = &SetEnumValue;
+		}
+		else if (CastField<FObjectProperty>(property))
+		{
+			plan.kind = PropertyKind::Object;
+			plan.setter = &SetObjectValue;
+		}
+		else if (auto* prop = CastField<FMapProperty>(property))
+		{
+			plan.kind = PropertyKind::Map;
+			plan.setter = &SetMapValue;
+			plan.inner = std::make_unique<PropertyWritePlan>(CompilePropertyPlan(prop->GetKeyProp()));
+			plan.value = std::make_unique<PropertyWritePlan>(CompilePropertyPlan(prop->GetValueProp()));
+		}
+		else if (auto* prop = CastField<FArrayProperty>(property))
+		{
+			plan.kind = PropertyKind::Array;
+			plan.setter = &SetArrayValue;
+			plan.inner = std::make_unique<PropertyWritePlan>(CompilePropertyPlan(prop->GetInner()));
+		}
+		else if (auto* prop = CastField<FStructProperty>(property))
+		{
+			plan.kind = PropertyKind::Struct;
+			plan.setter = &SetStructValue;
+			plan.structPlan = GetWritePlan(prop->GetStruct());
+			// A struct that is still being compiled (only reachable through a container) stays non-trivial
+			plan.trivial = plan.structPlan->trivial;
+		}
+		else
+		{
+			plan.kind = PropertyKind::Unsupported;
+			plan.setter = &SetUnsupportedValue;
+		}
+
+		return plan;
+	}
+
+	static auto SetPropertyValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+#if TFWWORKBENCH_TRACING || TFWWORKBENCH_STATS
+		bool tracing = TFWWORKBENCH_TRACING && s_tracing.load(std::memory_order_relaxed);
+		bool stats = WorkbenchStats::Enabled();
+		if (tracing || stats)
+		{
+			auto start = std::chrono::steady_clock::now();
+			bool written = plan.setter(value, plan, propertyPtr);
+			auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+			if (stats)
+			{
+				s_instance->m_stats.RecordField(plan.kind, static_cast<uint64>(elapsed.count()));
+			}
+#if TFWWORKBENCH_TRACING
+			if (tracing)
+			{
+				s_instance->m_trace.Push({
+					t_trace_context.table,
+					t_trace_context.row,
+					plan.fname,
+					plan.kind,
+					static_cast<uint32>(std::min<int64_t>(elapsed.count(), UINT32_MAX))
+				});
+			}
+#endif
+			return written;
+		}
+#endif
+		return plan.setter(value, plan, propertyPtr);
+	}
+
+	// Writes every string-keyed field of `fields` into `container`.
+	// Fields the struct doesn't have are skipped, and reported when `warnUnknown` is set.
+	static auto SetStructFields(const FieldValue& fields,
+		const StructWritePlan& structPlan,
+		void* container,
+		bool warnUnknown) -> void
+	{
+		for (const FieldValue::Entry& field : fields.get_table())
+		{
+			if (!field.key.is_string()) continue;
+
+			std::string_view fieldName = field.key.get_string();
+			const PropertyWritePlan* fieldPlan = structPlan.Find(fieldName);
+			if (!fieldPlan)
+			{
+				if (WorkbenchStats::Enabled()) s_instance->m_stats.RecordUnknownField();
+				if (warnUnknown)
+				{
+					Output::send<LogLevel::Warning>(
+						STR("[TFWWorkbench] Property '{}' not found, skipping\n"),
+						to_wstring(fieldName)
+					);
+				}
+				continue;
+			}
+
+			TFW_LOG_VERBOSE(STR("[TFWWorkbench] Processing field '{}'\n"), fieldPlan->name);
+
+			void* fieldPtr = static_cast<uint8*>(container) + fieldPlan->offset;
+			SetPropertyValue(field.value, *fieldPlan, fieldPtr);
+		}
+	}
+
+	// Escapes `value` for use inside a quoted text literal
+	static auto EscapeTextLiteral(std::string_view value) -> StringType
+	{
+		StringType escaped;
+		escaped.reserve(value.size());
+		for (CharType c : to_wstring(value))
+		{
+			if (c == STR('"') || c == STR('\\')) escaped.push_back(STR('\\'));
+			escaped.push_back(c);
+		}
+		return escaped;
+	}
+
+	// A string becomes culture invariant text directly. A table selects localized text instead:
+	//   { text = "...", namespace = "...", key = "..." }   NSLOCTEXT
+	//   { table = "...", key = "..." }                      LOCTABLE (string table entry)
+	static auto SetTextValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (value.is_string())
+		{
+			std::string_view propertyValue = value.get_string();
+			*static_cast<FText*>(propertyPtr) = s_instance->m_text_cache.FromString(propertyValue);
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set FText property '{}' to value: {}\n"),
+				plan.name, to_wstring(propertyValue)
+			);
+			return true;
+		}
+		else if (value.is_table())
+		{
+			std::string_view text, textNamespace, key, stringTable;
+			for (const FieldValue::Entry& part : value.get_table())
+			{
+				if (!part.key.is_string() || !part.value.is_string()) continue;
+
+				std::string_view name = part.key.get_string();
+				if (name == "text") text = part.value.get_string();
+				else if (name == "namespace") textNamespace = part.value.get_string();
+				else if (name == "key") key = part.value.get_string();
+				else if (name == "table") stringTable = part.value.get_string();
+			}
+
+			std::string cacheKey;
+			if (!stringTable.empty())
+			{
+				cacheKey.append("\x02").append(stringTable).append("\x1f").append(key);
+			}
+			else
+			{
+				cacheKey.append("\x01").append(textNamespace).append("\x1f").append(key).append("\x1f").append(text);
+			}
+
+			auto* textPtr = static_cast<FText*>(propertyPtr);
+			if (s_instance->m_text_cache.Find(cacheKey, *textPtr)) return true;
+
+			StringType literal = !stringTable.empty()
+				? STR("LOCTABLE(\"") + EscapeTextLiteral(stringTable) + STR("\", \"") + EscapeTextLiteral(key) + STR("\")")
+				: STR("NSLOCTEXT(\"") + EscapeTextLiteral(textNamespace) + STR("\", \"") + EscapeTextLiteral(key) + STR("\", \"") + EscapeTextLiteral(text) + STR("\")");
+			plan.property->ImportText_Direct(literal.c_str(), propertyPtr, nullptr, PPF_None, nullptr);
+			s_instance->m_text_cache.Add(cacheKey, *textPtr);
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set FText property '{}' to value: {}\n"),
+				plan.name, literal
+			);
+			return true;
+		}
+		return false;
+	}
+
+	static auto SetStrValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (value.is_string())
+		{
+			auto propertyValue = to_wstring(value.get_string());
+			*static_cast<FString*>(propertyPtr) = FString(propertyValue.c_str());
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set FString property '{}' to value: {}\n"),
+				plan.name, propertyValue
+			);
+			return true;
+		}
+		return false;
+	}
+
+	static auto SetNameValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (value.is_string())
+		{
+			std::string_view propertyValue = value.get_string();
+			*static_cast<FName*>(propertyPtr) = s_instance->m_name_cache.ToName(propertyValue);
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set FName property '{}' to value: {}\n"),
+				plan.name, to_wstring(propertyValue)
+			);
+			return true;
+		}
+		return false;
+	}
+
+	template<typename T>
+	static auto SetNumericValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (T propertyValue; ToNumeric(value, propertyValue))
+		{
+			*static_cast<T*>(propertyPtr) = propertyValue;
+
+			// Unary plus so 8-bit values are logged as numbers rather than characters
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set {} property '{}' to value: {}\n"),
+				to_wstring(PropertyKindName(plan.kind)), plan.name, +propertyValue
+			);
+			return true;
+		}
+		return false;
+	}
+
+	// Converts the elements of a sequence straight into the array storage at `data`, one typed
+	// store each. Stops at the first element that doesn't convert and returns its index.
+	template<typename T>
+	static auto FillNumericArray(const std::vector<FieldValue::Entry>& elements, void* data) -> size_t
+	{
+		T* element = static_cast<T*>(data);
+		for (size_t i = 0; i < elements.size(); i++)
+		{
+			if (!ToNumeric(elements[i].value, element[i])) return i;
+		}
+		return elements.size();
+	}
+
+	static auto SetBoolValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (bool propertyValue; value.to_bool(propertyValue))
+		{
+			// propertyPtr already points at the value, so the bitfield mask is applied directly
+			static_cast<FBoolProperty*>(plan.property)->SetPropertyValue(propertyPtr, propertyValue);
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set bool property '{}' to value: {}\n"),
+				plan.name, propertyValue
+			);
+			return true;
+		}
+		return false;
+	}
+
+	static auto SetSoftObjectValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (value.is_string())
+		{
+			std::string_view propertyValue = value.get_string();
+			s_instance->m_soft_path_cache.Write(plan.property, propertyValue, propertyPtr);
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set {} property '{}' to value: {}\n"),
+				plan.property->IsA<FSoftClassProperty>() ? STR("TSoftClassPr") : STR("TSoftObjectPtr"),
+				plan.name, to_wstring(propertyValue)
+			);
+			return true;
+		}
+		return false;
+	}
+
+	static auto SetEnumValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (double number; value.to_number(number))
+		{
+			int64_t propertyValue = static_cast<int64_t>(number);
+			FNumericProperty* underlyingProp = static_cast<FEnumProperty*>(plan.property)->GetUnderlyingProperty();
+			underlyingProp->SetIntPropertyValue(propertyPtr, propertyValue);
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set FEnumProperty property '{}' to value: {}\n"),
+				plan.name, propertyValue
+			);
+			return true;
+		}
+		return false;
+	}
+
+	static auto SetObjectValue(const FieldValue& value,
+		[[maybe_unused]] const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		// The value passed from Lua is the full asset path as a string
+		if (value.is_string())
+		{
+			std::string_view propertyValue = value.get_string();
+			UObject* obj = s_instance->m_object_cache.Find(propertyValue);
+
+			if (obj)
+			{
+				TFW_LOG_VERBOSE(
+					STR("[TFWWorkbench] Found object via path: {}\n"), to_wstring(propertyValue)
+				);
+				*reinterpret_cast<UObject**>(propertyPtr) = obj;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static auto GetMapLayout(const PropertyWritePlan& plan) -> FScriptMapLayout
+	{
+		FProperty* keyProp = plan.inner->property;
+		FProperty* valueProp = plan.value->property;
+		return FScriptMap::GetScriptLayout(
+			keyProp->GetElementSize(), keyProp->GetMinAlignment(),
+			valueProp->GetElementSize(), valueProp->GetMinAlignment());
+	}
+
+	static auto SetMapValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (value.is_table())
+		{
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set FMapProperty '{}'\n"),
+				plan.name
+			);
+
+			FProperty* keyProp = plan.inner->property;
+			FProperty* valueProp = plan.value->property;
+			auto* map = static_cast<FScriptMap*>(propertyPtr);
+			FScriptMapLayout scriptLayout = GetMapLayout(plan);
+			bool nameKeys = plan.inner->kind == PropertyKind::Name;
+
+			// A patched row already holds a map, whose entries are released before it is refilled
+			if (map->Num() > 0)
+			{
+				plan.property->DestroyValue(propertyPtr);
+				plan.property->InitializeValue(propertyPtr);
+			}
+
+			// The entry count is known up front, so storage is reserved once and the hash built once at the end
+			const auto& elements = value.get_table();
+			map->Empty(static_cast<int32>(elements.size()), scriptLayout);
+
+			// Lua keys can convert to the same map key, like 1 and "1" for a number, or names that
+			// only differ in case. The first element with a key is kept and later ones are dropped,
+			// a TMap can't hold a key twice. Other keys are converted into `keyBuffer` first, and only
+			// moved into the map once they are known to be new.
+			std::unordered_set<uint64> names;
+			std::unordered_set<std::string> keys;
+			std::unique_ptr<void, void(*)(void*)> keyBuffer(
+				nameKeys ? nullptr : FMemory::Malloc(keyProp->GetSize(), keyProp->GetMinAlignment()),
+				&FMemory::Free
+			);
+
+			const StructWritePlan* valuePlan = plan.value->structPlan;
+			for (const FieldValue::Entry& element : elements)
+			{
+				if (nameKeys ? !element.key.is_string() : element.key.is_nil()) continue;
+
+				// FName keys, by far the most common, skip the setter and its logging
+				FName name = {};
+				if (nameKeys)
+				{
+					name = s_instance->m_name_cache.ToName(element.key.get_string());
+					if (!names.insert(GetNameId(name)).second)
+					{
+						Output::send<LogLevel::Warning>(
+							STR("[TFWWorkbench] Map '{}' has several elements with key '{}', keeping the first\n"),
+							plan.name, to_wstring(element.key.get_string())
+						);
+						continue;
+					}
+				}
+				else
+				{
+					keyProp->InitializeValue(keyBuffer.get());
+					bool converted = SetPropertyValue(element.key, *plan.inner, keyBuffer.get());
+					if (!converted || !keys.insert(MapKeyId(*plan.inner, keyBuffer.get())).second)
+					{
+						keyProp->DestroyValue(keyBuffer.get());
+						if (converted)
+						{
+							Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Map '{}' has several elements with the same key, keeping the first\n"), plan.name);
+						}
+						else
+						{
+							Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Map '{}' has an element whose key doesn't convert, skipping it\n"), plan.name);
+						}
+						continue;
+					}
+				}
+
+				int32 index = map->AddUninitialized(scriptLayout);
+				uint8* entryData = static_cast<uint8*>(map->GetData(index, scriptLayout));
+				void* keyPtr = entryData;
+				void* valuePtr = entryData + scriptLayout.ValueOffset;
+
+				if (nameKeys)
+				{
+					new (keyPtr) FName(name);
+
+					TFW_LOG_VERBOSE(
+						STR("[TFWWorkbench] Map key: {}\n"), to_wstring(element.key.get_string())
+					);
+				}
+				else
+				{
+					// Moved, map pairs are relocated with memcpy as well
+					std::memcpy(keyPtr, keyBuffer.get(), keyProp->GetSize());
+				}
+
+				if (valuePlan)
+				{
+					valuePlan->scriptStruct->InitializeStruct(valuePtr);
+
+					if (element.value.is_table())
+					{
+						SetStructFields(element.value, *valuePlan, valuePtr, false);
+					}
+				}
+				else
+				{
+					valueProp->InitializeValue(valuePtr);
+					SetPropertyValue(element.value, *plan.value, valuePtr);
+				}
+			}
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Created map with {} elements\n"),
+				map->Num()
+			);
+
+			map->Rehash(scriptLayout, [keyProp](const void* key) -> uint32 {
+				return keyProp->GetValueTypeHash(key);
+			});
+			return true;
+		}
+		return false;
+	}
+
+	// Identifies the map key at `ptr`, telling keys apart the way the map does. FString keys
+	// ignore case, like TMap's.
+	static auto MapKeyId(const PropertyWritePlan& plan, void* ptr) -> std::string
+	{
+		if (plan.kind != PropertyKind::Str) return ReadIndexKey(plan, ptr);
+
+		StringType text(**static_cast<FString*>(ptr));
+		std::transform(text.begin(), text.end(), text.begin(), [](CharType c) {
+			return static_cast<CharType>(std::towlower(static_cast<wint_t>(c)));
+		});
+		return TextIndexKey(to_string(text));
+	}
+
+	static auto SetArrayValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (value.is_table())
+		{
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Set FArrayProperty '{}'\n"),
+				plan.name
+			);
+
+			FProperty* innerProp = plan.inner->property;
+			int32 elementSize = innerProp->GetSize();
+			uint32 elementAligment = innerProp->GetMinAlignment();
+
+			const auto& elements = value.get_table();
+			int32 count = static_cast<int32>(elements.size());
+
+			TFW_LOG_VERBOSE(
+				STR("[TFWWorkbench] Creating array with {} elements (elementSize={}, alignment={})\n"),
+				count, elementSize, elementAligment
+			);
+
+			auto* arr = static_cast<FScriptArray*>(propertyPtr);
+			// A patched row already holds an array, whose elements are released before it is refilled
+			if (arr->Num() > 0)
+			{
+				plan.property->DestroyValue(propertyPtr);
+				plan.property->InitializeValue(propertyPtr);
+			}
+			arr->Empty(count, elementSize, elementAligment);
+
+			if (count == 0) return true;
+
+			// Numbers are converted into the new storage in one pass, there is nothing to zero first.
+			// An element that isn't a valid number rejects the whole array, which is left empty.
+			const PropertyWritePlan& elementPlan = *plan.inner;
+			if (elementPlan.fill)
+			{
+				arr->Add(count, elementSize, elementAligment);
+				size_t converted = elementPlan.fill(elements, arr->GetData());
+				if (converted != elements.size())
+				{
+					arr->Empty(0, elementSize, elementAligment);
+					Output::send<LogLevel::Error>(
+						STR("[TFWWorkbench] Element {} of array '{}' is not a valid {}, the array is left empty\n"),
+						converted + 1, plan.name, to_wstring(PropertyKindName(elementPlan.kind))
+					);
+					return false;
+				}
+				return true;
+			}
+
+			// Allocate and zero-initialize
+			arr->AddZeroed(count, elementSize, elementAligment);
+
+			const StructWritePlan* elementStructPlan = elementPlan.structPlan;
+			uint8* data = static_cast<uint8*>(arr->GetData());
+			for (int32 i = 0; i < count; i++)
+			{
+				void* elemPtr = data + (i * elementSize);
+				if (elementStructPlan)
+				{
+					elementStructPlan->scriptStruct->InitializeStruct(elemPtr);
+
+					if (elements[i].value.is_table())
+					{
+						SetStructFields(elements[i].value, *elementStructPlan, elemPtr, false);
+					}
+				}
+				else
+				{
+					innerProp->InitializeValue(elemPtr);
+					SetPropertyValue(elements[i].value, elementPlan, elemPtr);
+				}
+			}
+			return true;
+		}
+		return false;
+	}
+
+	static auto SetStructValue(const FieldValue& value,
+		const PropertyWritePlan& plan,
+		void* propertyPtr) -> bool
+	{
+		if (value.is_table())
+		{
+			SetStructFields(value, *plan.structPlan, propertyPtr, false);
+			return true;
+		}
+		/* This doesn't work. Either causes a crash on game startup or UE4SS crashing on dumping the table.
+		* Probably fails in other instances too. When referencing the data.
+		*
+		else if (value.is_number())
+		{
+			auto innerStruct = static_cast<FStructProperty*>(plan.property)->GetStruct();
+			auto structName = innerStruct->GetName();
+			// This is to handle the case of FTimespan not having a `Ticks` field.
+			// Instead it's just 64 bit integer.
+			// NOTE: There's probably a better way to check for the class /Script/CoreUObject.Timespan
+			if (structName == STR("Timespan"))
+			{
+				int64_t propertyValue = value.get_integer();
+				*static_cast<int64_t*>(propertyPtr) = propertyValue;
+
+				TFW_LOG_VERBOSE(
+					STR("[TFWWorkbench] Set Timespan property '{}' to value: {}\n"),
+					plan.name, propertyValue
+				);
+			}
+		}
+		*/
+		return false;
+	}
+
+	static auto SetUnsupportedValue([[maybe_unused]] const FieldValue& value,
+		[[maybe_unused]] const PropertyWritePlan& plan,
+		[[maybe_unused]] void* propertyPtr) -> bool
+	{
+		return false;
+	}
+
+	// Writes the fields of a whole row and accounts them, and the time taken, to its table
+	static auto WriteRowFields(const DataTableEntry& entry, const StructWritePlan& plan, const FieldValue& fields, uint8* row) -> void
+	{
+		if (!WorkbenchStats::Enabled())
+		{
+			SetStructFields(fields, plan, row, true);
+			return;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		auto flush = [&] {
+			auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			s_instance->m_stats.RecordRow(entry.stats, static_cast<uint64>(elapsed.count()));
+		};
+
+		try
+		{
+			SetStructFields(fields, plan, row, true);
+		}
+		catch (...)
+		{
+			flush();
+			throw;
+		}
+		flush();
+	}
+
+	// Builds row `rowName` in a new allocation matching what UDataTable::AddRow makes, so
+	// RemoveRow/EmptyTable release it the same way once it is committed. With `image` the trivial
+	// fields are copied from it first, and `fields` only has to hold the rest. With `prototype`
+	// the whole row starts as a copy of that row instead. Touches nothing but the new row, the
+	// shared caches and `prototype`, and reads the table's layout from `layout` rather than the
+	// entry, so it also runs on the RowBuildPool workers. Returns the row, or nullptr on failure.
+	static auto BuildRow(const DataTableEntry& entry,
+		const RowLayout& layout,
+		FName rowName,
+		const FieldValue& fields,
+		const uint8* image,
+		const uint8* prototype = nullptr) -> uint8*
+	{
+		UScriptStruct* rowStruct = layout.rowStruct;
+		uint8* newRow = static_cast<uint8*>(FMemory::Malloc(rowStruct->GetStructureSize(), rowStruct->GetMinAlignment()));
+		if (!newRow)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Failed to allocate memory for new row\n"));
+			return nullptr;
+		}
+
+		rowStruct->InitializeStruct(newRow);
+
+		if (prototype)
+		{
+			rowStruct->CopyScriptStruct(newRow, prototype);
+		}
+		else if (image)
+		{
+			for (const PropertyWritePlan* field : layout.plan->trivialFields)
+			{
+				std::memcpy(newRow + field->offset, image + field->offset, field->property->GetSize());
+			}
+		}
+
+		t_trace_context = { &entry, rowName };
+
+		try
+		{
+			WriteRowFields(entry, *layout.plan, fields, newRow);
+		}
+		catch (...)
+		{
+			rowStruct->DestroyStruct(newRow);
+			FMemory::Free(newRow);
+			throw;
+		}
+
+		return newRow;
+	}
+
+	static auto GetNameId(FName name) -> uint64
+	{
+		return (static_cast<uint64>(name.GetComparisonIndex()) << 32) | name.GetNumber();
+	}
+
+	// Links a built row into the table, replacing any existing row with that name
+	static auto CommitRow(const DataTableEntry& entry, FName rowName, uint8* row) -> void
+	{
+		int32 rowCount = entry.table->GetRowMap().Num();
+		entry.table->RemoveRow(rowName);
+		entry.table->GetRowMap().Add(rowName, row);
+		ReindexRow(entry, rowName, row, rowCount);
+	}
+
+	// Builds row `rowName` and commits it, see BuildRow
+	static auto AddRow(const DataTableEntry& entry,
+		std::string_view rowName,
+		const FieldValue& fields,
+		const uint8* image = nullptr) -> uint8*
+	{
+		FName new_fname = s_instance->m_name_cache.ToName(rowName);
+		uint8* newRow = BuildRow(entry, entry.Layout(), new_fname, fields, image);
+		if (newRow)
+		{
+			CommitRow(entry, new_fname, newRow);
+		}
+		return newRow;
+	}
+
+	// Builds row `rowName` as a copy of `sourceName` with `overrides` written over it, and commits
+	// it. Fields of nested structs not named in the overrides keep the source's values, arrays
+	// and maps that are named are replaced whole. Returns the row, or nullptr when the table has
+	// no row `sourceName`.
+	static auto CloneRow(const DataTableEntry& entry,
+		std::string_view sourceName,
+		std::string_view rowName,
+		const FieldValue& overrides) -> uint8*
+	{
+		// Looked up on every clone, the game and other mods may remove or replace rows as well
+		FName sourceFName = s_instance->m_name_cache.ToName(sourceName);
+		const uint8* source = entry.table->FindRowUnchecked(sourceFName);
+		if (!source)
+		{
+			Output::send<LogLevel::Warning>(
+				STR("[TFWWorkbench] Row '{}' not found in '{}', nothing to clone\n"),
+				to_wstring(sourceName), to_wstring(entry.name)
+			);
+			return nullptr;
+		}
+
+		FName newFName = s_instance->m_name_cache.ToName(rowName);
+		uint8* newRow = BuildRow(entry, entry.Layout(), newFName, overrides, nullptr, source);
+		if (newRow)
+		{
+			CommitRow(entry, newFName, newRow);
+		}
+		return newRow;
+	}
+
+	// Writes `fields` into the existing row `rowName` in place, leaving every other field as it is.
+	// Returns the row, or nullptr when the table has no row with that name.
+	static auto PatchRow(const DataTableEntry& entry,
+		std::string_view rowName,
+		const FieldValue& fields) -> uint8*
+	{
+		FName rowFName = s_instance->m_name_cache.ToName(rowName);
+		uint8* row = entry.table->FindRowUnchecked(rowFName);
+		if (!row) return nullptr;
+
+		t_trace_context = { &entry, rowFName };
+		try
+		{
+			WriteRowFields(entry, *entry.plan, fields, row);
+		}
+		catch (...)
+		{
+			ReindexRow(entry, rowFName, row, entry.table->GetRowMap().Num());
+			throw;
+		}
+		ReindexRow(entry, rowFName, row, entry.table->GetRowMap().Num());
+		return row;
+	}
+
+	// Adds a row replayed from the row cache. While the RowStruct layout still matches the one
+	// the image was taken with, only the fixup fields are decoded and written. Otherwise the row
+	// is rebuilt from all of its cached fields and recorded into a replacement cache file.
+	static auto AddCachedRow(PendingRowWrite& write) -> uint8*
+	{
+		const DataTableEntry& entry = *write.entry;
+		RowCacheReplay& replay = *write.replay;
+		const RowCacheHeader& header = replay.file.Header();
+		bool layoutMatches = header.layoutHash == entry.plan->layoutHash &&
+			header.structSize == static_cast<uint32>(entry.rowStruct->GetStructureSize());
+
+		if (!layoutMatches && !replay.rebuild)
+		{
+			Output::send<LogLevel::Warning>(
+				STR("[TFWWorkbench] RowStruct of '{}' changed since its rows were cached, rebuilding the row cache\n"),
+				to_wstring(entry.name)
+			);
+			replay.rebuild = std::make_shared<RowCacheRecording>();
+			replay.rebuild->path = replay.path;
+			replay.rebuild->inputHash = header.inputHash;
+		}
+
+		CachedRow row = replay.file.ReadRow(write.cachedRow);
+		if (!ReadCachedFields(row, layoutMatches, write.fields))
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Damaged row cache entry for row '{}'\n"), to_wstring(write.rowName));
+			return nullptr;
+		}
+
+		return AddRow(entry, write.rowName, write.fields, layoutMatches ? row.image : nullptr);
+	}
+
+	// Appends a freshly built row to the recording of its import
+	static auto RecordRow(RowCacheRecording& recording,
+		const DataTableEntry& entry,
+		std::string_view rowName,
+		const FieldValue& fields,
+		const uint8* row) -> void
+	{
+		if (!recording.writer)
+		{
+			recording.writer = std::make_unique<RowCacheWriter>(
+				recording.inputHash,
+				entry.plan->layoutHash,
+				static_cast<uint32>(entry.rowStruct->GetStructureSize())
+			);
+		}
+
+		recording.writer->BeginRow(rowName, row);
+		for (const FieldValue::Entry& field : fields.get_table())
+		{
+			if (!field.key.is_string()) continue;
+
+			const PropertyWritePlan* fieldPlan = entry.plan->Find(field.key.get_string());
+			recording.writer->AddField(field.key, field.value, !fieldPlan || !fieldPlan->trivial);
+		}
+		recording.writer->EndRow();
+	}
+
+	// Hands `write` to the build workers when its row can be built off the game thread: a
+	// replacing write into a resolved table whose rows hold no object references. Rows replayed
+	// from a cache whose layout no longer matches are rebuilt on the game thread instead, and so
+	// are tracked rows written before, which mostly end up skipped or patched.
+	auto StageRowWrite(PendingRowWrite& write) -> void
+	{
+		DataTableEntry& entry = *write.entry;
+		if (write.staged || write.mode != RowWriteMode::Replace) return;
+		if (!entry.resolved.load(std::memory_order_acquire) || !entry.table || !entry.rowStruct || !entry.offThreadBuild) return;
+		if (write.input && HasRowInput(entry, write.rowName)) return;
+		if (write.replay)
+		{
+			const RowCacheHeader& header = write.replay->file.Header();
+			if (header.layoutHash != entry.plan->layoutHash ||
+				header.structSize != static_cast<uint32>(entry.rowStruct->GetStructureSize()))
+			{
+				return;
+			}
+		}
+		if (m_build_pool.ThreadCount() == 0) return;
+
+		write.staged = std::make_shared<StagedRow>();
+		write.staged->layout = entry.Layout();
+		write.staged->tableEpoch = entry.tableEpoch.load(std::memory_order_acquire);
+		m_build_pool.Submit([&write, staged = write.staged] {
+			BuildStagedRow(write, *staged);
+		});
+	}
+
+	// Runs on a build worker, or on the game thread while it waits for the row
+	static auto BuildStagedRow(PendingRowWrite& write, StagedRow& staged) -> void
+	{
+		if (staged.tableEpoch != write.entry->tableEpoch.load(std::memory_order_acquire))
+		{
+			staged.done.store(true, std::memory_order_release);
+			return;
+		}
+
+		try
+		{
+			staged.name = s_instance->m_name_cache.ToName(write.rowName);
+
+			const uint8* image = nullptr;
+			bool decoded = true;
+			if (write.replay)
+			{
+				CachedRow row = write.replay->file.ReadRow(write.cachedRow);
+				decoded = ReadCachedFields(row, true, write.fields);
+				image = row.image;
+			}
+
+			if (decoded)
+			{
+				staged.row = BuildRow(*write.entry, staged.layout, staged.name, write.fields, image);
+			}
+			else
+			{
+				Output::send<LogLevel::Error>(STR("[TFWWorkbench] Damaged row cache entry for row '{}'\n"), to_wstring(write.rowName));
+			}
+		}
+		catch (...)
+		{
+			staged.exception = std::current_exception();
+		}
+		staged.done.store(true, std::memory_order_release);
+	}
+
+	// Links a row built by the workers into its table. Rows built for a table that was destroyed
+	// since fail, the table loaded in its place may have another layout.
+	static auto CommitStagedRow(PendingRowWrite& write) -> uint8*
+	{
+		StagedRow& staged = *write.staged;
+		if (staged.image && staged.layout.rowStruct != write.entry->rowStruct)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Row image '{}' doesn't match the RowStruct of '{}'\n"),
+				to_wstring(write.rowName), to_wstring(write.entry->name)
+			);
+			return nullptr;
+		}
+		if (!staged.image && staged.tableEpoch != write.entry->tableEpoch.load(std::memory_order_acquire)) return nullptr;
+		if (staged.exception) std::rethrow_exception(staged.exception);
+		if (!staged.row) return nullptr;
+
+		uint8* row = std::exchange(staged.row, nullptr);
+		CommitRow(*write.entry, staged.name, row);
+		return row;
+	}
+
+	// Hashes the fields of a row write. The field hashes stay in the order of `fields` until the
+	// input is recorded.
+	static auto HashRowInput(const FieldValue& fields) -> std::unique_ptr<RowInput>
+	{
+		auto input = std::make_unique<RowInput>();
+		input->fields.reserve(fields.get_table().size());
+
+		// Summed, so the hash doesn't depend on the order the Lua table was walked in
+		uint64 sum = 0;
+		for (const FieldValue::Entry& field : fields.get_table())
+		{
+			uint64 keyHash = HashFieldValue(field.key);
+			uint64 valueHash = HashFieldValue(field.value, keyHash);
+			input->fields.emplace_back(keyHash, valueHash);
+			sum += valueHash;
+		}
+		input->hash = HashValue(sum, HashValue(input->fields.size(), HashSeed));
+		return input;
+	}
+
+	// Whether row `rowName` has a recorded input. Called from the Lua states as well.
+	static auto HasRowInput(const DataTableEntry& entry, std::string_view rowName) -> bool
+	{
+		std::lock_guard lock(entry.inputsMutex);
+		return entry.inputs.find(rowName) != entry.inputs.end();
+	}
+
+	// Drops the recorded input of row `rowName`, once a write that isn't tracked has replaced or
+	// changed the row
+	static auto ForgetRowInput(const DataTableEntry& entry, std::string_view rowName) -> void
+	{
+		// Only this thread adds inputs, so an empty map stays empty without the lock
+		if (entry.inputs.empty()) return;
+
+		std::lock_guard lock(entry.inputsMutex);
+		if (auto it = entry.inputs.find(rowName); it != entry.inputs.end())
+		{
+			entry.inputs.erase(it);
+		}
+	}
+
+	// Hashes the bytes of `row` itself, not what its strings, arrays and maps point to
+	static auto HashRowBytes(const DataTableEntry& entry, const uint8* row) -> uint64
+	{
+		return HashBytes(row, static_cast<size_t>(entry.rowStruct->GetStructureSize()));
+	}
+
+	// Collects the fields of `fields` whose hash differs from the one in `previous` into
+	// `changed`. Fails when a field was left out since, or a struct field changed: the row has
+	// to be rebuilt for those to fall back to their defaults.
+	static auto DiffRowInput(const DataTableEntry& entry,
+		const RowInput& previous,
+		const RowInput& input,
+		const FieldValue& fields,
+		FieldValue& changed) -> bool
+	{
+		size_t kept = 0;
+		const auto& entries = fields.get_table();
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			auto [keyHash, valueHash] = input.fields[i];
+			auto it = std::lower_bound(previous.fields.begin(), previous.fields.end(), std::pair<uint64, uint64>(keyHash, 0));
+			if (it != previous.fields.end() && it->first == keyHash)
+			{
+				kept++;
+				if (it->second == valueHash) continue;
+			}
+
+			const FieldValue::Entry& field = entries[i];
+			const PropertyWritePlan* fieldPlan = field.key.is_string() ? entry.plan->Find(field.key.get_string()) : nullptr;
+			if (fieldPlan && fieldPlan->kind == PropertyKind::Struct) return false;
+
+			changed.add(field.key, field.value);
+		}
+		return kept == previous.fields.size();
+	}
+
+	// Writes a row queued with incrementalWrites on. A row whose input hashes the same as the
+	// input it was last written from is left as it is, and one whose fields only changed value is
+	// patched with just those. Anything else is built from scratch, like any Replace write.
+	static auto WriteTrackedRow(PendingRowWrite& write) -> uint8*
+	{
+		const DataTableEntry& entry = *write.entry;
+		RowInput& input = *write.input;
+		uint8* existing = entry.table->FindRowUnchecked(s_instance->m_name_cache.ToName(write.rowName));
+
+		// Inputs are only recorded on this thread, so they are read without the lock
+		const RowInput* previous = nullptr;
+		if (auto it = entry.inputs.find(write.rowName); it != entry.inputs.end() && existing && it->second.row == existing &&
+			it->second.rowHash == HashRowBytes(entry, existing))
+		{
+			previous = &it->second;
+		}
+
+		if (previous && previous->hash == input.hash)
+		{
+			// A row staged anyway is dropped along with the write
+			if (WorkbenchStats::Enabled()) entry.stats.rowsUnchanged.fetch_add(1, std::memory_order_relaxed);
+			TFW_LOG_VERBOSE(STR("[TFWWorkbench] Row '{}' is unchanged\n"), to_wstring(write.rowName));
+			return existing;
+		}
+
+		uint8* row = nullptr;
+		try
+		{
+			FieldValue changed = FieldValue::make_table();
+			if (previous && !write.staged && DiffRowInput(entry, *previous, input, write.fields, changed))
+			{
+				row = PatchRow(entry, write.rowName, changed);
+				if (WorkbenchStats::Enabled()) entry.stats.rowsPatched.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				row = write.staged ? CommitStagedRow(write) : AddRow(entry, write.rowName, write.fields);
+			}
+		}
+		catch (...)
+		{
+			ForgetRowInput(entry, write.rowName);
+			throw;
+		}
+
+		if (!row)
+		{
+			ForgetRowInput(entry, write.rowName);
+			return nullptr;
+		}
+
+		input.row = row;
+		input.rowHash = HashRowBytes(entry, row);
+		std::sort(input.fields.begin(), input.fields.end());
+
+		std::lock_guard lock(entry.inputsMutex);
+		entry.changes.try_emplace(write.rowName, existing == nullptr);
+		entry.inputs.insert_or_assign(write.rowName, std::move(input));
+		return row;
+	}
+
+	// Writes a resolved row according to its mode. Returns the row, or nullptr on failure.
+	static auto WriteRow(PendingRowWrite& write) -> uint8*
+	{
+		if (write.input)
+		{
+			return WriteTrackedRow(write);
+		}
+		ForgetRowInput(*write.entry, write.rowName);
+
+		if (write.staged)
+		{
+			return CommitStagedRow(write);
+		}
+		if (write.replay)
+		{
+			return AddCachedRow(write);
+		}
+		if (write.mode == RowWriteMode::Clone)
+		{
+			return CloneRow(*write.entry, write.sourceRow, write.rowName, write.fields);
+		}
+		if (write.mode == RowWriteMode::Replace)
+		{
+			return AddRow(*write.entry, write.rowName, write.fields);
+		}
+
+		uint8* row = PatchRow(*write.entry, write.rowName, write.fields);
+		if (!row && write.mode == RowWriteMode::Upsert)
+		{
+			row = AddRow(*write.entry, write.rowName, write.fields);
+		}
+		else if (!row)
+		{
+			Output::send<LogLevel::Warning>(
+				STR("[TFWWorkbench] Row '{}' not found in '{}', nothing to patch\n"),
+				to_wstring(write.rowName), to_wstring(write.entry->name)
+			);
+		}
+		return row;
+	}
+
+	auto ApplyRowWrite(PendingRowWrite& write) -> bool
+	{
+		bool written = TryApplyRowWrite(write);
+		if (WorkbenchStats::Enabled())
+		{
+			(written ? write.entry->stats.rowsWritten : write.entry->stats.rowsFailed).fetch_add(1, std::memory_order_relaxed);
+		}
+		return written;
+	}
+
+	auto TryApplyRowWrite(PendingRowWrite& write) -> bool
+	{
+		try
+		{
+			uint8* row = nullptr;
+			if (ResolveDataTable(*write.entry))
+			{
+				// Rows are about to be freed or have containers reallocated, views look theirs up again
+				write.entry->generation.fetch_add(1, std::memory_order_release);
+				row = WriteRow(write);
+			}
+
+			RowCacheRecording* recording = write.recording ? write.recording.get()
+				: write.replay ? write.replay->rebuild.get()
+				: nullptr;
+			if (!row)
+			{
+				if (recording) recording->failed = true;
+				return false;
+			}
+
+			if (recording)
+			{
+				RecordRow(*recording, *write.entry, write.rowName, write.fields, row);
+			}
+
+			TFW_LOG_VERBOSE(STR("[TFWWorkbench] Successfully added row '{}'\n"), to_wstring(write.rowName));
+			return true;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Exception while adding row '{}': {}\n"),
+				to_wstring(write.rowName), to_wstring(e.what())
+			);
+			if (write.recording) write.recording->failed = true;
+			if (write.replay && write.replay->rebuild) write.replay->rebuild->failed = true;
+			return false;
+		}
+	}
+
+	// Applies queued row writes until the frame budget is spent. At least one write is applied
+	// per call so a budget that's too small still makes progress. Rows built by the workers are
+	// only linked in here, and a row still being built ends the frame's writes when the budget
+	// runs out waiting for it.
+	auto ApplyPendingRowWrites() -> void
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(m_frame_budget_us.load(std::memory_order_relaxed));
+
+		// Writes queued before their table was resolved go to the workers once it is
+		m_row_writes.ForEachUnchecked([this](PendingRowWrite& write) {
+			if (!write.staged && ResolveDataTable(*write.entry))
+			{
+				StageRowWrite(write);
+			}
+		});
+
+		int32 applied = 0;
+		int32 failed = 0;
+		while (PendingRowWrite* front = m_row_writes.Front())
+		{
+			if (front->staged)
+			{
+				bool first = applied == 0 && failed == 0;
+				if (!m_build_pool.WaitFor(front->staged->done, first ? std::chrono::steady_clock::time_point::max() : deadline)) break;
+			}
+
+			std::unique_ptr<PendingRowWrite> write = m_row_writes.Pop();
+			// Writes to a table destroyed since they were queued wait for it to be back, except for
+			// rows that were already built for it. Row images aren't built for a particular table.
+			if ((!write->staged || write->staged->image) && !ResolveDataTable(*write->entry) && ParkRowWrite(write, true)) continue;
+
+			if (ApplyRowWrite(*write)) applied++;
+			else failed++;
+
+			if (std::chrono::steady_clock::now() >= deadline) break;
+		}
+
+		if (applied > 0 || failed > 0)
+		{
+			Output::send<LogLevel::Default>(
+				STR("[TFWWorkbench] Applied {} row writes, {} failed, {} pending\n"),
+				applied, failed, m_row_writes.Size()
+			);
+		}
+	}
+
+	// With incrementalWrites on, hashes the input of a Replace write on the calling thread so
+	// applying it can compare it with the row's last input. Rows of imports are left to the row
+	// cache, and rows copied from images through the C API have no input to compare.
+	auto TrackRowWrite(PendingRowWrite& write) const -> void
+	{
+		if (write.mode != RowWriteMode::Replace || write.recording || write.replay || write.staged) return;
+		if (!m_incremental_writes.load(std::memory_order_relaxed)) return;
+
+		write.input = HashRowInput(write.fields);
+	}
+
+	// Parks `write` until its table resolves, unless it is resolved by now. Returns whether the
+	// write was taken. A `requeued` write comes off the queue, in queue order, and goes after the
+	// other requeued writes but before those parked when they were queued, which are newer.
+	auto ParkRowWrite(std::unique_ptr<PendingRowWrite>& write, bool requeued = false) -> bool
+	{
+		if (write->entry->resolved.load(std::memory_order_acquire)) return false;
+
+		std::lock_guard lock(m_parked_mutex);
+		if (write->entry->resolved.load(std::memory_order_acquire)) return false;
+
+		ParkedWrites& parked = m_parked_writes[write->entry];
+		if (requeued)
+		{
+			parked.writes.insert(parked.writes.begin() + static_cast<ptrdiff_t>(parked.requeued++), std::move(write));
+		}
+		else
+		{
+			parked.writes.push_back(std::move(write));
+		}
+		m_parked_count.fetch_add(1, std::memory_order_release);
+		return true;
+	}
+
+	// Queues row writes for on_update, handing those that can be built off the game thread to
+	// the workers right away. Writes to a table that isn't resolved yet are parked until it is.
+	auto QueueRowWrite(PendingRowWrite&& write) -> void
+	{
+		CaptureRowWrites({ &write, 1 });
+		auto queued = std::make_unique<PendingRowWrite>(std::move(write));
+		TrackRowWrite(*queued);
+		if (ParkRowWrite(queued)) return;
+
+		StageRowWrite(*queued);
+		m_row_writes.Push(std::move(queued));
+	}
+
+	auto QueueRowWrites(std::vector<PendingRowWrite>&& writes) -> void
+	{
+		CaptureRowWrites(writes);
+		std::vector<std::unique_ptr<PendingRowWrite>> queued;
+		queued.reserve(writes.size());
+		for (PendingRowWrite& write : writes)
+		{
+			auto pending = std::make_unique<PendingRowWrite>(std::move(write));
+			TrackRowWrite(*pending);
+			if (ParkRowWrite(pending)) continue;
+
+			StageRowWrite(*pending);
+			queued.push_back(std::move(pending));
+		}
+		if (!queued.empty()) m_row_writes.PushBatch(std::move(queued));
+	}
+
+	// Copies the Lua table at the top of the stack into a FieldValue
+	static auto MarshalTableArg(const LuaMadeSimple::Lua& lua) -> FieldValue
+	{
+		lua_State* L = lua.get_lua_state();
+#if TFWWORKBENCH_STACK_CHECKS
+		int stackBefore = lua_gettop(L);
+#endif
+		FieldValue value = FieldValueFromLua(L, -1);
+#if TFWWORKBENCH_STACK_CHECKS
+		int stackAfter = lua_gettop(L);
+		if (stackBefore != stackAfter)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] STACK IMBALANCE while marshalling: before={}, after={}\n"),
+				stackBefore, stackAfter
+			);
+		}
+#endif
+		return value;
+	}
+
+	// AddDataTableRow(table, rowName, { Field = value, ... })
+	// The row is queued and written on the game thread from on_update. Returns whether it was queued.
+	// Rows of a table that isn't loaded yet wait for it, and are written in the frame it has loaded.
+	static auto Lua_AddDataTableRow(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
+			return 1;
+		}
+
+		try
+		{
+			DataTableEntry* entry = GetDataTableArg(lua);
+			std::string_view newRowName = lua.is_string() ? lua.get_string() : "";
+			if (!entry || newRowName == "" || !lua.is_table())
+			{
+				Output::send<LogLevel::Error>(
+					STR("[TFWWorkbench] Invalid parameters. Expected: (string|handle, string, table)\n")
+				);
+				lua.set_bool(false);
+				return 1;
+			}
+
+			s_instance->QueueRowWrite({ entry, std::string(newRowName), MarshalTableArg(lua) });
+
+			lua.set_bool(true);
+			return 1;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Exception: {}\n"),
+				to_wstring(e.what())
+			);
+			lua.set_bool(false);
+			return 1;
+		}
+	}
+
+	// PatchDataTableRow(table, rowName, { Field = value, ... }, upsert)
+	// Queues a write of only the given fields into the existing row, leaving its other fields as
+	// they are. When the row doesn't exist the write fails, or with `upsert` the row is added
+	// instead. Returns whether the write was queued.
+	static auto Lua_PatchDataTableRow(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
+			return 1;
+		}
+
+		try
+		{
+			DataTableEntry* entry = GetDataTableArg(lua);
+			// Copied, get_string has already removed it from the stack
+			std::string rowName(lua.is_string() ? lua.get_string() : "");
+			if (!entry || rowName == "" || !lua.is_table())
+			{
+				Output::send<LogLevel::Error>(
+					STR("[TFWWorkbench] Invalid parameters. Expected: (string|handle, string, table, [bool])\n")
+				);
+				lua.set_bool(false);
+				return 1;
+			}
+
+			// Drop the optional flag so the fields table is at the top for marshalling
+			lua_State* L = lua.get_lua_state();
+			bool upsert = lua_gettop(L) >= 2 && lua_toboolean(L, 2);
+			lua_settop(L, 1);
+
+			s_instance->QueueRowWrite({
+				entry,
+				std::move(rowName),
+				MarshalTableArg(lua),
+				nullptr,
+				nullptr,
+				nullptr,
+				upsert ? RowWriteMode::Upsert : RowWriteMode::Patch
+			});
+
+			lua.set_bool(true);
+			return 1;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Exception: {}\n"),
+				to_wstring(e.what())
+			);
+			lua.set_bool(false);
+			return 1;
+		}
+	}
+
+	// CloneDataTableRow(table, sourceRow, newRow, { Field = value, ... })
+	// Queues a write of `newRow` as a copy of `sourceRow`, with only the given fields written over
+	// it. The overrides are optional. The source row is looked up when the write is applied, so it
+	// may be queued in the same frame. Returns whether the write was queued.
+	static auto Lua_CloneDataTableRow(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
+			return 1;
+		}
+
+		try
+		{
+			DataTableEntry* entry = GetDataTableArg(lua);
+			// get_string has already removed the names from the stack, so copy them before Lua allocates
+			std::string sourceRow(lua.is_string() ? lua.get_string() : "");
+			std::string newRowName(lua.is_string() ? lua.get_string() : "");
+			bool hasOverrides = lua.is_table();
+			if (!entry || sourceRow == "" || newRowName == "" || (!hasOverrides && !lua_isnoneornil(lua.get_lua_state(), 1)))
+			{
+				Output::send<LogLevel::Error>(
+					STR("[TFWWorkbench] Invalid parameters. Expected: (string|handle, string, string, [table])\n")
+				);
+				lua.set_bool(false);
+				return 1;
+			}
+
+			s_instance->QueueRowWrite({
+				entry,
+				std::move(newRowName),
+				hasOverrides ? MarshalTableArg(lua) : FieldValue::make_table(),
+				nullptr,
+				nullptr,
+				nullptr,
+				RowWriteMode::Clone,
+				std::move(sourceRow)
+			});
+
+			lua.set_bool(true);
+			return 1;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Exception: {}\n"),
+				to_wstring(e.what())
+			);
+			lua.set_bool(false);
+			return 1;
+		}
+	}
+
+	// AddDataTableRows(table, { RowName = { Field = value, ... }, ... })
+	// Queues every row in one go. Returns a table mapping each row name to whether it was queued.
+	static auto Lua_AddDataTableRows(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
+			return 1;
+		}
+
+		try
+		{
+			DataTableEntry* entry = GetDataTableArg(lua);
+			if (!entry || !lua.is_table())
+			{
+				Output::send<LogLevel::Error>(
+					STR("[TFWWorkbench] Invalid parameters. Expected: (string|handle, table)\n")
+				);
+				lua.set_bool(false);
+				return 1;
+			}
+
+			FieldValue rows = MarshalTableArg(lua);
+
+			std::vector<PendingRowWrite> writes;
+			writes.reserve(rows.get_table().size());
+			std::vector<std::pair<std::string, bool>> results;
+			for (FieldValue::Entry& row : rows.get_table())
+			{
+				if (!row.key.is_string()) continue;
+
+				std::string_view rowName = row.key.get_string();
+				bool queued = rowName != "" && row.value.is_table();
+				if (queued)
+				{
+					writes.push_back({ entry, std::string(rowName), std::move(row.value) });
+				}
+				else
+				{
+					Output::send<LogLevel::Warning>(
+						STR("[TFWWorkbench] Invalid row '{}' in batch, expected a table of fields\n"),
+						to_wstring(rowName)
+					);
+				}
+
+				results.emplace_back(rowName, queued);
+			}
+
+			Output::send<LogLevel::Default>(
+				STR("[TFWWorkbench] Queued {} of {} rows for '{}'\n"),
+				writes.size(), results.size(), to_wstring(entry->name)
+			);
+			s_instance->QueueRowWrites(std::move(writes));
+
+			lua_State* L = lua.get_lua_state();
+			lua_createtable(L, 0, static_cast<int>(results.size()));
+			for (const auto& [rowName, queued] : results)
+			{
+				lua_pushboolean(L, queued);
+				lua_setfield(L, -2, rowName.c_str());
+			}
+			return 1;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Exception: {}\n"),
+				to_wstring(e.what())
+			);
+			lua.set_bool(false);
+			return 1;
+		}
+	}
+
+	// ImportDataTableRows(table, filePath)
+	// Parses a JSON or CSV file (see RowImport.hpp for the layouts) on the calling Lua state and
+	// queues its rows like AddDataTableRows does. Returns the number of rows queued, or false
+	// when the file can't be read or parsed. Rows before a parse error are still queued.
+	// When the file is unchanged since a previous import into the same table, its rows are
+	// replayed from the row cache instead of being parsed (see RowCache.hpp).
+	static auto Lua_ImportDataTableRows(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
+			return 1;
+		}
+
+		try
+		{
+			DataTableEntry* entry = GetDataTableArg(lua);
+			std::string_view filePath = lua.is_string() ? lua.get_string() : "";
+			if (!entry || filePath == "")
+			{
+				Output::send<LogLevel::Error>(
+					STR("[TFWWorkbench] Invalid parameters. Expected: (string|handle, string)\n")
+				);
+				lua.set_bool(false);
+				return 1;
+			}
+
+			std::filesystem::path path(std::u8string(filePath.begin(), filePath.end()));
+			MappedFile file(path);
+			if (!file.IsOpen())
+			{
+				Output::send<LogLevel::Error>(STR("[TFWWorkbench] Failed to open {}\n"), to_wstring(filePath));
+				lua.set_bool(false);
+				return 1;
+			}
+
+			// Rows go to the queue in chunks so a large file starts applying before it is fully parsed
+			constexpr size_t ChunkSize = 256;
+			std::vector<PendingRowWrite> writes;
+			writes.reserve(ChunkSize);
+			size_t queued = 0;
+			auto queueWrite = [&](PendingRowWrite&& write) {
+				writes.push_back(std::move(write));
+				if (writes.size() == ChunkSize)
+				{
+					queued += writes.size();
+					s_instance->QueueRowWrites(std::move(writes));
+					writes.clear();
+					writes.reserve(ChunkSize);
+				}
+			};
+
+			std::filesystem::path cachePath = s_instance->GetRowCachePath(*entry, path);
+			uint64 inputHash = cachePath.empty() ? 0 : HashBytes(file.Data(), file.Size());
+			if (!cachePath.empty())
+			{
+				auto replay = std::make_shared<RowCacheReplay>(cachePath, inputHash);
+				entry->stats.rowCache.Record(replay->file.IsValid());
+				if (replay->file.IsValid())
+				{
+					for (const char* record : replay->file.Rows())
+					{
+						queueWrite({ entry, std::string(replay->file.ReadRow(record).name), {}, nullptr, replay, record });
+					}
+					queued += writes.size();
+					s_instance->QueueRowWrites(std::move(writes));
+
+					Output::send<LogLevel::Default>(
+						STR("[TFWWorkbench] Queued {} cached rows from {} for '{}'\n"),
+						queued, to_wstring(filePath), to_wstring(entry->name)
+					);
+					lua.set_integer(static_cast<int64_t>(queued));
+					return 1;
+				}
+			}
+
+			std::shared_ptr<RowCacheRecording> recording;
+			if (!cachePath.empty())
+			{
+				recording = std::make_shared<RowCacheRecording>();
+				recording->path = cachePath;
+				recording->inputHash = inputHash;
+			}
 
+			std::string error;
+			bool parsed = ReadRowDocument(
+				path,
+				file.View(),
+				[&](std::string_view rowName, FieldValue& fields) {
+					if (rowName == "") return;
+					queueWrite({ entry, std::string(rowName), std::move(fields), recording });
+				},
+				error
+			);
 
-constexpr size_t INVENTORY_ITEM_DETAILS_SIZE = 0x240;
+			// Still referenced here, so the recording can't have been saved yet
+			if (!parsed && recording) recording->failed = true;
 
-using namespace RC;
-using namespace RC::Unreal;
+			queued += writes.size();
+			s_instance->QueueRowWrites(std::move(writes));
 
-class TFWWorkbench : public RC::CppUserModBase
-{
-private:
-	// Static instance pointer for use in static lua callbacks
-	static TFWWorkbench* s_instance;
+			if (!parsed)
+			{
+				Output::send<LogLevel::Error>(
+					STR("[TFWWorkbench] Failed to import {}: {}\n"),
+					to_wstring(filePath), to_wstring(error)
+				);
+				lua.set_bool(false);
+				return 1;
+			}
 
-	std::map<std::string, UDataTable*> m_cached_data_table = {};
-	std::map<std::string, UScriptStruct*> m_cached_row_struct = {};
+			Output::send<LogLevel::Default>(
+				STR("[TFWWorkbench] Queued {} rows from {} for '{}'\n"),
+				queued, to_wstring(filePath), to_wstring(entry->name)
+			);
+			lua.set_integer(static_cast<int64_t>(queued));
+			return 1;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Exception: {}\n"),
+				to_wstring(e.what())
+			);
+			lua.set_bool(false);
+			return 1;
+		}
+	}
 
-	std::map<std::string, StringType> dataTables = {};
+	// Index keys. Whole numbers share the integer key whatever the width of their property, so
+	// 5 finds a float field holding 5.0. Names are keyed by FName, which compares them without
+	// regard to case, and everything else by its text.
+	static auto IntegerIndexKey(int64 value) -> std::string
+	{
+		std::string key(1 + sizeof(value), 'I');
+		std::memcpy(key.data() + 1, &value, sizeof(value));
+		return key;
+	}
 
-public:
-	TFWWorkbench() : CppUserModBase()
+	static auto NumberIndexKey(double value) -> std::string
 	{
-		ModName = STR("TFWWorkbench");
-		ModVersion = STR("0.1");
-		ModDescription = STR("Manage items, vendors, crafting recipes, and more for TFW");
-		ModAuthors = STR("terraru");
+		if (value == std::trunc(value) && value >= -0x1p63 && value < 0x1p63)
+		{
+			return IntegerIndexKey(static_cast<int64>(value));
+		}
 
-		s_instance = this;
+		std::string key(1 + sizeof(value), 'D');
+		std::memcpy(key.data() + 1, &value, sizeof(value));
+		return key;
 	}
 
-	~TFWWorkbench() override
+	static auto NameIndexKey(FName name) -> std::string
 	{
-		s_instance = nullptr;
+		uint64 id = GetNameId(name);
+		std::string key(1 + sizeof(id), 'N');
+		std::memcpy(key.data() + 1, &id, sizeof(id));
+		return key;
 	}
 
-	auto on_update() -> void override
+	static auto TextIndexKey(std::string_view text) -> std::string
 	{
+		std::string key = "S";
+		key += text;
+		return key;
 	}
 
-	auto on_unreal_init() -> void override
+	template<typename... Codecs>
+	static auto NumericIndexKey(PropertyKind kind, const void* ptr, std::string& key, std::tuple<Codecs...>*) -> bool
 	{
+		auto read = [&]<typename Codec>(Codec*) -> bool {
+			using T = typename Codec::Value;
+			if (kind != Codec::kind) return false;
 
+			T value = *static_cast<const T*>(ptr);
+			if constexpr (std::is_floating_point_v<T>) key = NumberIndexKey(static_cast<double>(value));
+			else if (std::in_range<int64>(value)) key = IntegerIndexKey(static_cast<int64>(value));
+			else key = NumberIndexKey(static_cast<double>(value));
+			return true;
+		};
+		return (read(static_cast<Codecs*>(nullptr)) || ...);
 	}
 
-	auto on_lua_start(LuaMadeSimple::Lua& lua,
-		LuaMadeSimple::Lua& main_lua,
-		LuaMadeSimple::Lua& async_lua,
-		LuaMadeSimple::Lua* hook_lua) -> void override
+	// Key of the value of `plan` at `ptr`
+	static auto ReadIndexKey(const PropertyWritePlan& plan, void* ptr) -> std::string
 	{
-		main_lua.register_function("AddDataTableRow", &TFWWorkbench::Lua_AddDataTableRow);
-		main_lua.register_function("ConfigureDataTables", &TFWWorkbench::Lua_ConfigureDataTables);
+		std::string key;
+		if (plan.fill && NumericIndexKey(plan.kind, ptr, key, static_cast<NumericCodecs*>(nullptr)))
+		{
+			return key;
+		}
 
-		async_lua.register_function("AddDataTableRow", &TFWWorkbench::Lua_AddDataTableRow);
-		async_lua.register_function("ConfigureDataTables", &TFWWorkbench::Lua_ConfigureDataTables);
+		switch (plan.kind)
+		{
+		case PropertyKind::Bool:
+			return IntegerIndexKey(static_cast<FBoolProperty*>(plan.property)->GetPropertyValue(ptr) ? 1 : 0);
+		case PropertyKind::Enum:
+			return IntegerIndexKey(static_cast<FEnumProperty*>(plan.property)->GetUnderlyingProperty()->GetSignedIntPropertyValue(ptr));
+		case PropertyKind::Name:
+			return NameIndexKey(*static_cast<FName*>(ptr));
+		case PropertyKind::Str:
+			return TextIndexKey(to_string(StringType(**static_cast<FString*>(ptr))));
+		case PropertyKind::Text:
+			return TextIndexKey(to_string(static_cast<FText*>(ptr)->ToString()));
+		case PropertyKind::Object:
+		{
+			UObject* object = *static_cast<UObject**>(ptr);
+			return TextIndexKey(object ? to_string(object->GetPathName()) : "");
+		}
+		default:
+		{
+			FString text;
+			plan.property->ExportTextItem(text, ptr, nullptr, nullptr, PPF_None);
+			return TextIndexKey(to_string(StringType(*text)));
+		}
+		}
+	}
 
-		if (hook_lua)
+	// Key a query for `value` looks up in an index over `plan`. Fails when the value can't be
+	// held by the field, so it can match no row.
+	static auto ToIndexKey(const PropertyWritePlan& plan, const FieldValue& value, std::string& key) -> bool
+	{
+		if (plan.fill || plan.kind == PropertyKind::Enum || plan.kind == PropertyKind::Bool)
 		{
-			hook_lua->register_function("AddDataTableRow", &TFWWorkbench::Lua_AddDataTableRow);
-			hook_lua->register_function("ConfigureDataTables", &TFWWorkbench::Lua_AddDataTableRow);
+			int64_t integer = 0;
+			double number = 0.0;
+			bool boolean = false;
+			if (plan.kind == PropertyKind::Bool && value.to_bool(boolean)) key = IntegerIndexKey(boolean ? 1 : 0);
+			else if (value.to_integer(integer)) key = IntegerIndexKey(integer);
+			else if (value.to_number(number)) key = NumberIndexKey(number);
+			else return false;
+			return true;
 		}
 
-		Output::send<LogLevel::Default>(STR("[TFWWorkbench] Registered Lua functions for mod\n"));
+		if (!value.is_string()) return false;
+
+		key = plan.kind == PropertyKind::Name
+			? NameIndexKey(s_instance->m_name_cache.ToName(value.get_string()))
+			: TextIndexKey(value.get_string());
+		return true;
 	}
 
-private:
-	auto GetDataTable(std::string tableName) -> UDataTable*
+	// Resolves `fieldPath`, a field of the row or a dotted path into nested structs, into
+	// `index`. Arrays and maps on the way are stepped through, so "Ingredients.Item" indexes the
+	// Item of every element of Ingredients. Returns false when the path names no plain value.
+	static auto ResolveIndexPath(const StructWritePlan& rowPlan, std::string_view fieldPath, RowIndex& index) -> bool
 	{
-		if (!m_cached_data_table.contains(tableName))
+		const StructWritePlan* structPlan = &rowPlan;
+		while (structPlan)
 		{
-			try
-			{
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Caching DataTable: {}\n"),
-					to_wstring(tableName)
-				);
-				m_cached_data_table[tableName] = static_cast<UDataTable*>(
-					UObjectGlobals::StaticFindObject<UObject*>(
-						nullptr,
-						nullptr,
-						dataTables.at(tableName)
-					)
-				);
-			}
-			catch (const std::out_of_range& ex)
+			size_t dot = fieldPath.find('.');
+			const PropertyWritePlan* field = structPlan->Find(fieldPath.substr(0, dot));
+			if (!field) return false;
+			index.path.push_back(field);
+
+			// What the field holds for every row: the elements of an array, the values of a map or
+			// its keys when the path ends there
+			const PropertyWritePlan* held = field->kind == PropertyKind::Array ? field->inner.get()
+				: field->kind == PropertyKind::Map ? (dot == std::string_view::npos ? field->inner.get() : field->value.get())
+				: field;
+			if (dot == std::string_view::npos)
 			{
-				Output::send<LogLevel::Error>(
-					STR("[TFWWorkbench] Failed to cache DataTable: {}\n"),
-					to_wstring(ex.what())
-				);
-				return nullptr;
+				index.leaf = held;
+				return held->kind != PropertyKind::Struct && held->kind != PropertyKind::Array && held->kind != PropertyKind::Map;
 			}
+
+			structPlan = held->kind == PropertyKind::Struct ? held->structPlan : nullptr;
+			fieldPath.remove_prefix(dot + 1);
 		}
-		return m_cached_data_table[tableName];
+		return false;
 	}
 
-	auto GetDataTableRowStruct(std::string tableName) -> UScriptStruct*
+	// Appends the keys of the struct at `structPtr` from step `step` of the index path on
+	static auto CollectIndexKeys(const RowIndex& index, size_t step, void* structPtr, std::vector<std::string>& keys) -> void
 	{
-		if (!m_cached_row_struct.contains(tableName))
+		const PropertyWritePlan& field = *index.path[step];
+		void* ptr = static_cast<uint8*>(structPtr) + field.offset;
+		bool last = step + 1 == index.path.size();
+		auto visit = [&](void* held) {
+			if (last) keys.push_back(ReadIndexKey(*index.leaf, held));
+			else CollectIndexKeys(index, step + 1, held, keys);
+		};
+
+		if (field.kind == PropertyKind::Array)
 		{
-			Output::send<LogLevel::Verbose>(
-				STR("[TFWWorkbench] Caching RowStruct for DataTable: {}\n"), 
-				to_wstring(tableName)
-			);
-			try
+			auto* arr = static_cast<FScriptArray*>(ptr);
+			auto* data = static_cast<uint8*>(arr->GetData());
+			int32 elementSize = field.inner->property->GetSize();
+			for (int32 i = 0; i < arr->Num(); i++)
 			{
-				m_cached_row_struct[tableName] = this->GetDataTable(tableName)->GetRowStruct();
+				visit(data + static_cast<size_t>(i) * elementSize);
 			}
-			catch (const std::exception& ex)
+		}
+		else if (field.kind == PropertyKind::Map)
+		{
+			int32 valueOffset = GetMapLayout(field).ValueOffset;
+			int32 maxIndex = static_cast<FScriptMap*>(ptr)->GetMaxIndex();
+			for (int32 i = 0; i < maxIndex; i++)
 			{
-				Output::send<LogLevel::Error>(
-					STR("[TFWWorkbench] Failed to cache RowStruct for DataTable {}: {}\n"),
-					to_wstring(tableName),
-					to_wstring(ex.what())
-				);
-				return nullptr;
+				if (uint8* pair = GetMapPair(field, ptr, i)) visit(last ? pair : pair + valueOffset);
 			}
 		}
-		return m_cached_row_struct[tableName];
+		else
+		{
+			visit(ptr);
+		}
 	}
 
-	static auto SetPropertyValueFromLua(const LuaMadeSimple::Lua& lua,
-		LuaMadeSimple::LuaTableReference table,
-		FProperty* property,
-		void* propertyPtr,
-		const std::wstring propertyName) -> void
+	// Takes row `rowName` out of `index`, and files it again under the keys of `row` if given
+	static auto IndexRow(RowIndex& index, FName rowName, void* row) -> void
 	{
-		if (auto* prop = CastField<FTextProperty>(property))
+		uint64 id = GetNameId(rowName);
+		std::string utf8Name;
+		if (auto it = index.entries.find(id); it != index.entries.end())
 		{
-			if (table.value.is_string())
+			const RowIndex::Row* indexed = &it->second;
+			for (const std::string& key : indexed->keys)
 			{
-				auto propertyValue = to_wstring(table.value.get_string());
-				FString quotedValue = FString::Printf(STR("NSLOCTEXT(\"\", \"\", \"%s\")"), propertyValue.c_str());
-				prop->ImportText_Direct(quotedValue.GetCharArray().GetData(), propertyPtr, nullptr, PPF_None, nullptr);
+				auto rows = index.rows.find(key);
+				if (rows == index.rows.end()) continue;
 
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set FText property '{}' to value: {}\n"),
-					propertyName, propertyValue
-				);
+				std::vector<const RowIndex::Row*>& found = rows->second;
+				if (auto position = std::find(found.begin(), found.end(), indexed); position != found.end())
+				{
+					*position = found.back();
+					found.pop_back();
+				}
+				if (found.empty()) index.rows.erase(rows);
 			}
+			utf8Name = std::move(it->second.utf8Name);
+			index.entries.erase(it);
 		}
-		else if (auto* prop = CastField<FStrProperty>(property))
+
+		if (!row) return;
+
+		std::vector<std::string> keys;
+		CollectIndexKeys(index, 0, row, keys);
+		if (keys.empty()) return;
+
+		// A row holding the same value twice, say in two array elements, is found once
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+		if (utf8Name.empty()) utf8Name = to_string(rowName.ToString());
+		const RowIndex::Row& indexed = index.entries.try_emplace(id, rowName, std::move(utf8Name), std::move(keys)).first->second;
+		for (const std::string& key : indexed.keys)
 		{
-			if (table.value.is_string())
-			{
-				auto propertyValue = to_wstring(table.value.get_string());
-				*static_cast<FString*>(propertyPtr) = FString(propertyValue.c_str());
+			index.rows[key].push_back(&indexed);
+		}
+	}
 
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set FString property '{}' to value: {}\n"),
-					propertyName, propertyValue
-				);
-			}
+	// Fills `index` with a single pass over the row map
+	static auto BuildRowIndex(const DataTableEntry& entry, RowIndex& index) -> void
+	{
+		index.rows.clear();
+		index.entries.clear();
+
+		auto& rowMap = entry.table->GetRowMap();
+		for (auto& row : rowMap)
+		{
+			IndexRow(index, row.Key, row.Value);
 		}
-		else if (auto* prop = CastField<FNameProperty>(property))
+		index.rowCount = rowMap.Num();
+	}
+
+	// Refiles row `rowName` in every index of its table, after the workbench wrote it
+	static auto ReindexRow(const DataTableEntry& entry, FName rowName, uint8* row, int32 rowCountBefore) -> void
+	{
+		if (!entry.indexed.load(std::memory_order_acquire)) return;
+
+		std::unique_lock lock(entry.indexesMutex);
+		int32 rowCount = entry.table->GetRowMap().Num();
+		for (auto& [fieldPath, index] : entry.indexes)
 		{
-			if (table.value.is_string())
-			{
-				auto propertyValue = to_wstring(table.value.get_string());
-				*static_cast<FName*>(propertyPtr) = FName(propertyValue.c_str(), FNAME_Add);
+			IndexRow(*index, rowName, row);
+			// An index that already missed rows added or removed by others stays stale, so the
+			// next query rebuilds it
+			if (index->rowCount == rowCountBefore) index->rowCount = rowCount;
+		}
+	}
 
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbecnh] Set FName property '{}' to value: {}\n"),
-					propertyName, propertyValue
-				);
+	// Looks up the rows whose `fieldPath` holds `value`, building the index over that field
+	// first when it is queried for the first time. Returns false when the path is invalid.
+	static auto FindRows(const DataTableEntry& entry,
+		std::string_view fieldPath,
+		const FieldValue& value,
+		std::vector<std::pair<FName, std::string>>& rows) -> bool
+	{
+		auto lookup = [&](const RowIndex& index) {
+			std::string key;
+			if (!ToIndexKey(*index.leaf, value, key)) return;
+
+			auto it = index.rows.find(key);
+			if (it == index.rows.end()) return;
+
+			rows.reserve(it->second.size());
+			for (const RowIndex::Row* row : it->second)
+			{
+				rows.emplace_back(row->name, row->utf8Name);
 			}
-		}
-		else if (auto* prop = CastField<FIntProperty>(property))
+		};
+
 		{
-			if (table.value.is_integer())
+			std::shared_lock lock(entry.indexesMutex);
+			auto it = entry.indexes.find(fieldPath);
+			if (it != entry.indexes.end() && it->second->rowCount == entry.table->GetRowMap().Num())
 			{
-				int64_t propertyValue = table.value.get_integer();
-				*static_cast<int32*>(propertyPtr) = static_cast<int32>(propertyValue);
-
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set int32 property '{}' to value: {}\n"),
-					propertyName, propertyValue
-				);
+				lookup(*it->second);
+				return true;
 			}
 		}
-		else if (auto* prop = CastField<FFloatProperty>(property))
-		{
-			if (table.value.is_number())
-			{
-				// That's a bit odd. Have to use get_number instead of get_float.
-				// Otherwise the value would be 0.
-				double propertyValue = table.value.get_number();
-				*static_cast<float*>(propertyPtr) = static_cast<float>(propertyValue);
 
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set float property '{}' to value: {}\n"),
-					propertyName, propertyValue
-				);
-			}
+		std::unique_lock lock(entry.indexesMutex);
+		auto it = entry.indexes.find(fieldPath);
+		if (it == entry.indexes.end())
+		{
+			auto index = std::make_unique<RowIndex>();
+			if (!ResolveIndexPath(*entry.plan, fieldPath, *index)) return false;
+			it = entry.indexes.emplace(std::string(fieldPath), std::move(index)).first;
 		}
-		else if (auto* prop = CastField<FBoolProperty>(property))
+
+		RowIndex& index = *it->second;
+		if (index.rowCount != entry.table->GetRowMap().Num())
 		{
-			if (table.value.is_bool())
-			{
-				bool propertyValue = table.value.get_bool();
-				prop->SetPropertyValueInContainer(propertyPtr, propertyValue);
+			auto start = std::chrono::steady_clock::now();
+			BuildRowIndex(entry, index);
+			Output::send<LogLevel::Default>(
+				STR("[TFWWorkbench] Indexed {} rows of '{}' by '{}' in {}us\n"),
+				index.rowCount, to_wstring(entry.name), to_wstring(fieldPath),
+				std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()
+			);
+		}
+		entry.indexed.store(true, std::memory_order_release);
 
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set bool property '{}' to value: {}\n"),
-					propertyName, propertyValue
-				);
-			}
+		lookup(index);
+		return true;
+	}
+
+	// Address of the pair at sparse index `index` of the map at `container`, or nullptr when there is none
+	static auto GetMapPair(const PropertyWritePlan& plan, void* container, int32 index) -> uint8*
+	{
+		auto* map = static_cast<FScriptMap*>(container);
+		if (index < 0 || index >= map->GetMaxIndex() || !map->IsValidIndex(index)) return nullptr;
+		return static_cast<uint8*>(map->GetData(index, GetMapLayout(plan)));
+	}
+
+	// Address of element `index` of the array at `container`, or of the value at sparse index
+	// `index` of the map at `container`. Returns nullptr when there is no such element.
+	static auto GetElementPtr(const PropertyWritePlan& plan, void* container, int32 index) -> void*
+	{
+		if (plan.kind == PropertyKind::Map)
+		{
+			uint8* pair = GetMapPair(plan, container, index);
+			return pair ? pair + GetMapLayout(plan).ValueOffset : nullptr;
 		}
-		else if (auto* prop = CastField<FSoftObjectProperty>(property))
+
+		auto* arr = static_cast<FScriptArray*>(container);
+		if (index < 0 || index >= arr->Num()) return nullptr;
+		return static_cast<uint8*>(arr->GetData()) + static_cast<size_t>(index) * plan.inner->property->GetSize();
+	}
+
+	// Returns the memory `view` shows, looking it up again from the row when the table has been
+	// written since. Returns nullptr once the row or the element is gone, or the table with them.
+	static auto ResolveRowView(RowView& view) -> void*
+	{
+		const DataTableEntry& entry = *view.entry;
+		// A table loaded anew may have another row struct, which the view's plans don't describe
+		if (view.tableEpoch != entry.tableEpoch.load(std::memory_order_acquire) ||
+			!entry.resolved.load(std::memory_order_acquire) || !entry.table)
 		{
-			if (table.value.is_string())
-			{
-				auto propertyValue = to_wstring(table.value.get_string());
-				prop->ImportText_Direct(
-					propertyValue.c_str(),
-					propertyPtr,
-					nullptr,
-					PPF_None,
-					nullptr
-				);
+			view.data = nullptr;
+			return nullptr;
+		}
 
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set {} property '{}' to value: {}\n"),
-					prop->IsA<FSoftClassProperty>() ? STR("TSoftClassPr") : STR("TSoftObjectPtr"),
-					propertyName, propertyValue
-				);
-			}
+		uint64 generation = entry.generation.load(std::memory_order_acquire);
+		if (view.data && view.generation == generation) return view.data;
+
+		void* data = entry.table->FindRowUnchecked(view.row);
+		for (const RowViewStep& step : view.path)
+		{
+			if (!data) break;
+			data = step.index < 0
+				? static_cast<uint8*>(data) + step.plan->offset
+				: GetElementPtr(*step.plan, data, step.index);
 		}
-		else if (auto* prop = CastField<FDoubleProperty>(property))
+
+		view.data = data;
+		view.generation = generation;
+		return data;
+	}
+
+	static auto PushUtf8(lua_State* L, const StringType& value) -> void
+	{
+		std::string utf8 = to_string(value);
+		lua_pushlstring(L, utf8.data(), utf8.size());
+	}
+
+	static auto PushRowView(lua_State* L, RowView&& view) -> void
+	{
+		new (lua_newuserdatauv(L, sizeof(RowView), 0)) RowView(std::move(view));
+		if (luaL_newmetatable(L, RowView::MetatableName))
 		{
-			if (table.value.is_number())
-			{
-				double propertyValue = table.value.get_number();
-				*static_cast<double*>(propertyPtr) = propertyValue;
+			lua_pushcfunction(L, &RowView_Index);
+			lua_setfield(L, -2, "__index");
+			lua_pushcfunction(L, &RowView_NewIndex);
+			lua_setfield(L, -2, "__newindex");
+			lua_pushcfunction(L, &RowView_Len);
+			lua_setfield(L, -2, "__len");
+			lua_pushcfunction(L, &RowView_Pairs);
+			lua_setfield(L, -2, "__pairs");
+			lua_pushcfunction(L, &RowView_ToString);
+			lua_setfield(L, -2, "__tostring");
+			lua_pushcfunction(L, &RowView_Gc);
+			lua_setfield(L, -2, "__gc");
+		}
+		lua_setmetatable(L, -2);
+	}
 
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set double property '{}' to value: {}\n"),
-					propertyName, propertyValue
-				);
-			}
+	// Pushes the numeric value at `ptr` when `kind` is one of NumericCodecs. 64-bit unsigned
+	// values past the Lua integer range are pushed as floats.
+	template<typename... Codecs>
+	static auto PushNumericValue(lua_State* L, PropertyKind kind, const void* ptr, std::tuple<Codecs...>*) -> bool
+	{
+		auto push = [&]<typename Codec>(Codec*) -> bool {
+			using T = typename Codec::Value;
+			if (kind != Codec::kind) return false;
+
+			T value = *static_cast<const T*>(ptr);
+			if constexpr (std::is_floating_point_v<T>) lua_pushnumber(L, static_cast<lua_Number>(value));
+			else if (std::in_range<lua_Integer>(value)) lua_pushinteger(L, static_cast<lua_Integer>(value));
+			else lua_pushnumber(L, static_cast<lua_Number>(value));
+			return true;
+		};
+		return (push(static_cast<Codecs*>(nullptr)) || ...);
+	}
+
+	// Pushes the value of `plan` at `ptr`. Structs and containers become views nested in `parent`,
+	// one `step` further down, and everything else is converted right away. Without a parent
+	// (map keys) they are pushed as exported text instead.
+	static auto PushFieldValue(lua_State* L,
+		const RowView* parent,
+		const PropertyWritePlan& plan,
+		void* ptr,
+		RowViewStep step) -> void
+	{
+		if (plan.fill && PushNumericValue(L, plan.kind, ptr, static_cast<NumericCodecs*>(nullptr)))
+		{
+			return;
 		}
-		else if (auto* prop = CastField<FEnumProperty>(property))
+
+		switch (plan.kind)
 		{
-			if (table.value.is_number())
+		case PropertyKind::Bool:
+			lua_pushboolean(L, static_cast<FBoolProperty*>(plan.property)->GetPropertyValue(ptr));
+			return;
+		case PropertyKind::Enum:
+			lua_pushinteger(L, static_cast<FEnumProperty*>(plan.property)->GetUnderlyingProperty()->GetSignedIntPropertyValue(ptr));
+			return;
+		case PropertyKind::Str:
+			PushUtf8(L, StringType(**static_cast<FString*>(ptr)));
+			return;
+		case PropertyKind::Name:
+			PushUtf8(L, static_cast<FName*>(ptr)->ToString());
+			return;
+		case PropertyKind::Text:
+			PushUtf8(L, static_cast<FText*>(ptr)->ToString());
+			return;
+		case PropertyKind::Object:
+			// The path, which is what the object setter takes
+			if (UObject* object = *static_cast<UObject**>(ptr)) PushUtf8(L, object->GetPathName());
+			else lua_pushnil(L);
+			return;
+		case PropertyKind::Struct:
+		case PropertyKind::Array:
+		case PropertyKind::Map:
+			if (parent && (plan.kind != PropertyKind::Struct || plan.structPlan))
 			{
-				int64_t propertyValue = table.value.get_number();
-				FNumericProperty* underlyingProp = prop->GetUnderlyingProperty();
-				underlyingProp->SetIntPropertyValue(propertyPtr, propertyValue);
-
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set FEnumProperty property '{}' to value: {}\n"),
-					propertyName, propertyValue
-				);
+				RowView view{ parent->entry, parent->row, ptr, nullptr, nullptr, parent->generation, parent->tableEpoch, parent->path };
+				if (plan.kind == PropertyKind::Struct) view.structPlan = plan.structPlan;
+				else view.containerPlan = &plan;
+				view.path.push_back(step);
+				PushRowView(L, std::move(view));
+				return;
 			}
+			break;
+		default:
+			break;
 		}
-		else if (auto* prop = CastField<FObjectProperty>(property))
+
+		// Soft references and everything without a dedicated conversion read as the text the
+		// editor would export for them
+		FString text;
+		plan.property->ExportTextItem(text, ptr, nullptr, nullptr, PPF_None);
+		PushUtf8(L, StringType(*text));
+	}
+
+	// view[key]: a field name for structs, a 1-based index for arrays, a key for FName keyed maps
+	static auto RowView_Index(lua_State* L) -> int
+	{
+		auto* view = static_cast<RowView*>(luaL_checkudata(L, 1, RowView::MetatableName));
+		try
 		{
-			// The value passed from Lua is the full asset path as a string
-			if (table.value.is_string())
+			void* data = ResolveRowView(*view);
+			if (!data)
 			{
-				auto propertyValue = to_wstring(table.value.get_string());
-				UObject* obj = UObjectGlobals::StaticFindObject(
-					nullptr,
-					nullptr,
-					propertyValue
-				);
+				lua_pushnil(L);
+				return 1;
+			}
 
-				if (obj)
+			if (view->structPlan)
+			{
+				size_t length = 0;
+				const char* key = lua_type(L, 2) == LUA_TSTRING ? lua_tolstring(L, 2, &length) : nullptr;
+				const PropertyWritePlan* field = key ? view->structPlan->Find({ key, length }) : nullptr;
+				if (!field)
 				{
-					Output::send<LogLevel::Verbose>(
-						STR("[TFWWorkbench] Found object via path: {}\n"), propertyValue
-					);
-					*reinterpret_cast<UObject**>(propertyPtr) = obj;
+					lua_pushnil(L);
+					return 1;
 				}
-			}
-		}
-		else if (auto* prop = CastField<FMapProperty>(property))
-		{
-			if (table.value.is_table())
-			{
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set FMapProperty '{}'\n"),
-					propertyName
-				);
-
-				// Count map elements first
-				int32 count = 0;
-				lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference element) -> bool {
-					count++;
-					return false;
-				});
-				if (count == 0) return;
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Creating map with {} elements\n"),
-					count
-				);
-
-				FProperty* keyProp = prop->GetKeyProp();
-				FProperty* valueProp = prop->GetValueProp();
-				auto* map = static_cast<FScriptMap*>(propertyPtr);
-				FScriptMapLayout scriptLayout = map->GetScriptLayout(
-					keyProp->GetElementSize(), keyProp->GetMinAlignment(),
-					valueProp->GetElementSize(), valueProp->GetMinAlignment());
-
-				map->Empty(0, scriptLayout);
 
-				// Only supports FName for key and FStruct for value
-				lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference element) -> bool {
-					int32 index = map->AddUninitialized(scriptLayout);
-					uint8* entryData = static_cast<uint8*>(map->GetData(index, scriptLayout));
-					void* keyPtr = entryData;
-					void* valuePtr = entryData + scriptLayout.ValueOffset;
-
-					if (auto* keyNameProp = CastField<FNameProperty>(keyProp))
-					{
-						if (element.key.is_string())
-						{
-							auto keyStr = to_wstring(element.key.get_string());
-							*static_cast<FName*>(keyPtr) = FName(keyStr.c_str(), FNAME_Add);
-
-							Output::send<LogLevel::Verbose>(
-								STR("[TFWWorkbench] Map key: {}\n"), keyStr
-							);
-						}
-					}
-
-					if (auto* valueStructProp = CastField<FStructProperty>(valueProp))
-					{
-						UScriptStruct* valueStruct = valueStructProp->GetStruct();
-						valueStruct->InitializeStruct(valuePtr);
+				PushFieldValue(L, view, *field, static_cast<uint8*>(data) + field->offset, { field, -1 });
+				return 1;
+			}
 
-						if (element.value.is_table())
-						{
-							lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference valueField) -> bool {
-								if (!valueField.key.is_string()) return false;
-
-								auto fieldName = to_wstring(valueField.key.get_string());
-								FProperty* fieldProp = valueStruct->GetPropertyByNameInChain(fieldName.c_str());
-
-								if (fieldProp)
-								{
-									void* fieldPtr = fieldProp->ContainerPtrToValuePtr<void>(valuePtr);
-									SetPropertyValueFromLua(lua, valueField, fieldProp, fieldPtr, fieldName);
-								}
-								
-								return false;
-							});
-						}
-					}
+			const PropertyWritePlan& container = *view->containerPlan;
+			int32 index = -1;
+			if (container.kind == PropertyKind::Array)
+			{
+				lua_Integer position = lua_isinteger(L, 2) ? lua_tointeger(L, 2) : 0;
+				if (position >= 1 && position <= INT32_MAX) index = static_cast<int32>(position - 1);
+			}
+			else if (CastField<FNameProperty>(container.inner->property) && lua_type(L, 2) == LUA_TSTRING)
+			{
+				FName key = s_instance->m_name_cache.ToName(lua_tostring(L, 2));
+				auto* map = static_cast<FScriptMap*>(data);
+				for (int32 i = 0; i < map->GetMaxIndex() && index < 0; i++)
+				{
+					uint8* pair = GetMapPair(container, data, i);
+					if (pair && *reinterpret_cast<FName*>(pair) == key) index = i;
+				}
+			}
 
-					return false;
-				});
+			void* element = index >= 0 ? GetElementPtr(container, data, index) : nullptr;
+			if (!element)
+			{
+				lua_pushnil(L);
+				return 1;
 			}
+
+			const PropertyWritePlan& elementPlan = container.kind == PropertyKind::Map ? *container.value : *container.inner;
+			PushFieldValue(L, view, elementPlan, element, { &container, index });
+			return 1;
 		}
-		else if (auto* prop = CastField<FArrayProperty>(property))
+		catch (const std::exception& e)
 		{
-			if (table.value.is_table())
-			{
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Set FArrayProperty '{}'\n"),
-					propertyName
-				);
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Exception while reading row: {}\n"), to_wstring(e.what()));
+			lua_pushnil(L);
+			return 1;
+		}
+	}
 
-				FProperty* innerProp = prop->GetInner();
-				int32 elementSize = innerProp->GetSize();
-				uint32 elementAligment = innerProp->GetMinAlignment();
+	static auto RowView_NewIndex(lua_State* L) -> int
+	{
+		return luaL_error(L, "row views are read-only, use PatchDataTableRow to change a row");
+	}
 
-				// Count elements first
-				int32 count = 0;
-				lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference element) -> bool {
-					count++;
-					return false;
-				});
+	// #view: the element count of arrays and maps, the field count of structs
+	static auto RowView_Len(lua_State* L) -> int
+	{
+		auto* view = static_cast<RowView*>(luaL_checkudata(L, 1, RowView::MetatableName));
+		void* data = ResolveRowView(*view);
+		if (!data) lua_pushinteger(L, 0);
+		else if (view->structPlan) lua_pushinteger(L, static_cast<lua_Integer>(view->structPlan->fieldOrder.size()));
+		else if (view->containerPlan->kind == PropertyKind::Array) lua_pushinteger(L, static_cast<FScriptArray*>(data)->Num());
+		else lua_pushinteger(L, static_cast<FScriptMap*>(data)->Num());
+		return 1;
+	}
 
-				Output::send<LogLevel::Verbose>(
-					STR("[TFWWorkbench] Creating array with {} elements (elementSize={}, alignment={})\n"),
-					count, elementSize, elementAligment
-				);
+	// pairs(view) iterates fields in property order, array elements in order or map pairs.
+	// The position lives in an upvalue of the iterator, so resuming never searches for the last key.
+	static auto RowView_Pairs(lua_State* L) -> int
+	{
+		luaL_checkudata(L, 1, RowView::MetatableName);
+		lua_pushinteger(L, 0);
+		lua_pushcclosure(L, &RowView_Next, 1);
+		lua_pushvalue(L, 1);
+		lua_pushnil(L);
+		return 3;
+	}
 
-				auto* arr = static_cast<FScriptArray*>(propertyPtr);
-				arr->Empty(0, elementSize, elementAligment);
+	static auto RowView_Next(lua_State* L) -> int
+	{
+		auto* view = static_cast<RowView*>(luaL_checkudata(L, 1, RowView::MetatableName));
+		try
+		{
+			lua_Integer position = lua_tointeger(L, lua_upvalueindex(1));
+			auto advance = [&](lua_Integer next) {
+				lua_pushinteger(L, next);
+				lua_replace(L, lua_upvalueindex(1));
+			};
 
-				if (count == 0) return;
+			void* data = ResolveRowView(*view);
+			if (!data) return 0;
 
-				// Allocate and zero-initialize
-				arr->AddZeroed(count, elementSize, elementAligment);
+			if (view->structPlan)
+			{
+				const auto& fields = view->structPlan->fieldOrder;
+				if (position >= static_cast<lua_Integer>(fields.size())) return 0;
 
-				uint8* data = static_cast<uint8*>(arr->GetData());
+				const PropertyWritePlan* field = fields[position];
+				advance(position + 1);
+				PushUtf8(L, field->name);
+				PushFieldValue(L, view, *field, static_cast<uint8*>(data) + field->offset, { field, -1 });
+				return 2;
+			}
 
-				if (auto* innerStructProp = CastField<FStructProperty>(innerProp))
-				{
-					UScriptStruct* elementStruct = innerStructProp->GetStruct();
-					for (int32 i = 0; i < count; i++)
-					{
-						elementStruct->InitializeStruct(data + (i * elementSize));
-					}
-				}
+			const PropertyWritePlan& container = *view->containerPlan;
+			if (container.kind == PropertyKind::Array)
+			{
+				auto index = static_cast<int32>(position);
+				void* element = GetElementPtr(container, data, index);
+				if (!element) return 0;
 
-				// Fill from lua table
-				int32 index = 0;
-				lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference element) -> bool {
-					void* elemPtr = data + (index * elementSize);
+				advance(position + 1);
+				lua_pushinteger(L, position + 1);
+				PushFieldValue(L, view, *container.inner, element, { &container, index });
+				return 2;
+			}
 
-					// Array element is a StructProperty
-					if (auto* innerStructProp = CastField<FStructProperty>(innerProp))
-					{
-						if (element.value.is_table())
-						{
-							UScriptStruct* elementStruct = innerStructProp->GetStruct();
-							
-							lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference field) -> bool {
-								if (!field.key.is_string()) return false;
-
-								auto fieldName = to_wstring(field.key.get_string());
-								FProperty* fieldProp = elementStruct->GetPropertyByNameInChain(fieldName.c_str());
-
-								if (fieldProp)
-								{
-									void* fieldPtr = fieldProp->ContainerPtrToValuePtr<void>(elemPtr);
-									SetPropertyValueFromLua(lua, field, fieldProp, fieldPtr, fieldName);
-								}
-
-								return false;
-							});
-						}
-					}
+			auto* map = static_cast<FScriptMap*>(data);
+			for (auto index = static_cast<int32>(position); index < map->GetMaxIndex(); index++)
+			{
+				uint8* pair = GetMapPair(container, data, index);
+				if (!pair) continue;
 
-					index++;
-					return false;
-				});
+				advance(index + 1);
+				PushFieldValue(L, nullptr, *container.inner, pair, {});
+				PushFieldValue(L, view, *container.value, pair + GetMapLayout(container).ValueOffset, { &container, index });
+				return 2;
 			}
+			return 0;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Exception while reading row: {}\n"), to_wstring(e.what()));
+			return 0;
+		}
+	}
+
+	static auto RowView_ToString(lua_State* L) -> int
+	{
+		auto* view = static_cast<RowView*>(luaL_checkudata(L, 1, RowView::MetatableName));
+		std::string name = "RowView(" + view->entry->name + ":" + to_string(view->row.ToString()) + ")";
+		lua_pushlstring(L, name.data(), name.size());
+		return 1;
+	}
+
+	static auto RowView_Gc(lua_State* L) -> int
+	{
+		static_cast<RowView*>(luaL_checkudata(L, 1, RowView::MetatableName))->~RowView();
+		return 0;
+	}
+
+	// GetDataTableRow(table, rowName)
+	// Returns a read-only view of the row, or false when the table has no such row. Nothing is
+	// converted up front: a field is read from the row memory when it's indexed, and structs,
+	// arrays and maps come back as nested views. pairs() and # work on every view. A view follows
+	// its row through later writes and reads nil once the row or its table is gone, also after the
+	// table is loaded again. Assigning to a view raises an error. Views read memory that queued
+	// writes change on the game thread, so read them once the writes are applied. Only
+	// registered on the main Lua state.
+	static auto Lua_GetDataTableRow(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
+			return 1;
 		}
-		else if (auto* prop = CastField<FStructProperty>(property))
+
+		try
 		{
-			if (table.value.is_table())
+			DataTableEntry* entry = GetDataTableArg(lua);
+			std::string_view rowName = lua.is_string() ? lua.get_string() : "";
+			if (!entry || rowName == "")
 			{
-				auto innerStruct = prop->GetStruct();
-
-				lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference innerTable) -> bool {
-					if (!innerTable.key.is_string()) return false;
+				Output::send<LogLevel::Error>(
+					STR("[TFWWorkbench] Invalid parameters. Expected: (string|handle, string)\n")
+				);
+				lua.set_bool(false);
+				return 1;
+			}
 
-					auto innerPropertyName = to_wstring(innerTable.key.get_string());
-					FProperty* innerProperty = innerStruct->GetPropertyByNameInChain(innerPropertyName.c_str());
-					if (innerProperty)
-					{
-						void* innerPropertyPtr = innerProperty->ContainerPtrToValuePtr<void>(propertyPtr);
-						SetPropertyValueFromLua(lua, innerTable, innerProperty, innerPropertyPtr, innerPropertyName);
-					}
-					return false;
-				});
+			if (!s_instance->ResolveDataTable(*entry))
+			{
+				lua.set_bool(false);
+				return 1;
 			}
-			/* This doesn't work. Either causes a crash on game startup or UE4SS crashing on dumping the table.
-			* Probably fails in other instances too. When referencing the data.
-			*
-			else if (table.value.is_number())
-			{
-				auto innerStruct = prop->GetStruct();
-				auto structName = innerStruct->GetName();
-				// This is to handle the case of FTimespan not having a `Ticks` field.
-				// Instead it's just 64 bit integer.
-				// NOTE: There's probably a better way to check for the class /Script/CoreUObject.Timespan
-				if (structName == STR("Timespan"))
-				{
-					int64_t propertyValue = table.value.get_integer();
-					*static_cast<int64_t*>(propertyPtr) = propertyValue;
 
-					Output::send<LogLevel::Verbose>(
-						STR("[TFWWorkbench] Set Timespan property '{}' to value: {}\n"),
-						propertyName, propertyValue
-					);
-				}
+			RowView view{ entry, s_instance->m_name_cache.ToName(rowName) };
+			view.tableEpoch = entry->tableEpoch.load(std::memory_order_acquire);
+			if (!ResolveRowView(view))
+			{
+				TFW_LOG_VERBOSE(STR("[TFWWorkbench] Row '{}' not found in '{}'\n"), to_wstring(rowName), to_wstring(entry->name));
+				lua.set_bool(false);
+				return 1;
 			}
-			*/
+
+			view.structPlan = entry->plan;
+			PushRowView(lua.get_lua_state(), std::move(view));
+			return 1;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Exception: {}\n"),
+				to_wstring(e.what())
+			);
+			lua.set_bool(false);
+			return 1;
 		}
 	}
 
-	static auto Lua_AddDataTableRow(const LuaMadeSimple::Lua& lua) -> int
+	// FindDataTableRows(table, field, value, [views])
+	// Returns the names of the rows whose `field` equals `value`, in no particular order, or row
+	// views like GetDataTableRow's when `views` is true. `field` may be a dotted path through
+	// nested structs, and arrays and maps on the way match when any element does:
+	// "Ingredients.Item" finds the rows with an ingredient `value`, "Items" a map keyed by it.
+	// The first query of a field indexes it over every row, later ones are a hash lookup. Rows
+	// written by the workbench are refiled as they are written. Rows added or removed by the game
+	// or other mods are seen through the table's row count, but their edits to rows in place,
+	// and replacements that keep the count, aren't. Returns false when the field isn't found.
+	// Only registered on the main Lua state, like GetDataTableRow.
+	static auto Lua_FindDataTableRows(const LuaMadeSimple::Lua& lua) -> int
 	{
 		if (!s_instance)
 		{
@@ -503,117 +4678,392 @@ private:
 
 		try
 		{
-			std::string_view tableName = lua.get_string();
-			std::string_view newRowName = lua.get_string();
-			if (tableName == "" || newRowName == "" || !lua.is_table())
+			lua_State* L = lua.get_lua_state();
+			DataTableEntry* entry = GetDataTableArg(lua);
+			// Copied, get_string has already removed it from the stack
+			std::string fieldPath(lua.is_string() ? lua.get_string() : "");
+			if (!entry || fieldPath == "" || lua_isnoneornil(L, 1))
 			{
 				Output::send<LogLevel::Error>(
-					STR("[TFWWorkbench] Invalid parameters. Expected: (string, string, table)\n")
+					STR("[TFWWorkbench] Invalid parameters. Expected: (string|handle, string, value, [bool])\n")
 				);
 				lua.set_bool(false);
 				return 1;
 			}
 
-			UDataTable* dataTable = s_instance->GetDataTable(static_cast<std::string>(tableName));
-			if (!dataTable)
+			FieldValue value = FieldValueFromLua(L, 1);
+			lua_remove(L, 1);
+			bool views = lua.is_bool() && lua.get_bool();
+
+			if (!s_instance->ResolveDataTable(*entry))
 			{
-				Output::send<LogLevel::Error>(STR("[TFWWorkbench] DataTable not found: {}\n"), to_wstring(tableName));
 				lua.set_bool(false);
 				return 1;
 			}
 
-			UScriptStruct* rowStruct;
-			try
+			std::vector<std::pair<FName, std::string>> rows;
+			if (!FindRows(*entry, fieldPath, value, rows))
 			{
-				rowStruct = s_instance->GetDataTableRowStruct(static_cast<std::string>(tableName));
+				Output::send<LogLevel::Error>(
+					STR("[TFWWorkbench] '{}' is not a field of '{}' that can be searched\n"),
+					to_wstring(fieldPath), to_wstring(entry->name)
+				);
+				lua.set_bool(false);
+				return 1;
 			}
-			catch (...)
+
+			lua_createtable(L, static_cast<int>(rows.size()), 0);
+			lua_Integer position = 0;
+			for (const auto& [rowName, utf8Name] : rows)
 			{
-				rowStruct = dataTable->GetRowStruct();
+				if (views)
+				{
+					RowView view{ entry, rowName };
+					view.tableEpoch = entry->tableEpoch.load(std::memory_order_acquire);
+					if (!ResolveRowView(view)) continue;
+
+					view.structPlan = entry->plan;
+					PushRowView(L, std::move(view));
+				}
+				else
+				{
+					lua_pushlstring(L, utf8Name.data(), utf8Name.size());
+				}
+				lua_rawseti(L, -2, ++position);
 			}
+			return 1;
+		}
+		catch (const std::exception& e)
+		{
+			Output::send<LogLevel::Error>(
+				STR("[TFWWorkbench] Exception: {}\n"),
+				to_wstring(e.what())
+			);
+			lua.set_bool(false);
+			return 1;
+		}
+	}
+
+	// Snapshot of every counter, in the layout GetWorkbenchStats returns and the stats file holds
+	auto CollectStats() const -> FieldValue
+	{
+		auto counter = [](FieldValue& table, std::string_view name, uint64 value) {
+			table.add(FieldValue::from_string(name), FieldValue::from_integer(static_cast<int64_t>(value)));
+		};
+		auto load = [](const std::atomic<uint64>& value) {
+			return value.load(std::memory_order_relaxed);
+		};
 
-			if (!rowStruct)
+		FieldValue tables = FieldValue::make_table();
+		{
+			std::shared_lock lock(m_data_tables_mutex);
+			for (const auto& entry : m_data_tables)
 			{
-				Output::send<LogLevel::Error>(STR("[TFWWorkbench] DataTable RowStruct not found\n"));
-				lua.set_bool(false);
-				return 1;
+				const WorkbenchStats::Table& stats = entry->stats;
+				FieldValue table = FieldValue::make_table();
+				counter(table, "rowsWritten", load(stats.rowsWritten));
+				counter(table, "rowsFailed", load(stats.rowsFailed));
+				counter(table, "rowsUnchanged", load(stats.rowsUnchanged));
+				counter(table, "rowsPatched", load(stats.rowsPatched));
+				counter(table, "fieldsWritten", load(stats.fieldsWritten));
+				counter(table, "unknownFields", load(stats.unknownFields));
+				counter(table, "rowsBuilt", load(stats.rows.count));
+				counter(table, "totalNs", load(stats.rows.nanoseconds));
+				counter(table, "maxNs", load(stats.rows.maxNanoseconds));
+				counter(table, "resolveNs", load(stats.resolveNanoseconds));
+				counter(table, "rowCacheHits", load(stats.rowCache.hits));
+				counter(table, "rowCacheMisses", load(stats.rowCache.misses));
+				tables.add(FieldValue::from_string(entry->name), std::move(table));
 			}
+		}
+
+		FieldValue fields = FieldValue::make_table();
+		std::array<WorkbenchStats::KindTotals, PropertyKindCount> kinds = m_stats.FieldTotals();
+		for (size_t i = 0; i < PropertyKindCount; i++)
+		{
+			if (kinds[i].count == 0) continue;
+
+			FieldValue kind = FieldValue::make_table();
+			counter(kind, "count", kinds[i].count);
+			counter(kind, "totalNs", kinds[i].nanoseconds);
+			counter(kind, "maxNs", kinds[i].maxNanoseconds);
+			fields.add(FieldValue::from_string(PropertyKindName(static_cast<PropertyKind>(i))), std::move(kind));
+		}
+
+		FieldValue caches = FieldValue::make_table();
+		auto cache = [&](std::string_view name, const WorkbenchStats::Cache& stats) {
+			FieldValue table = FieldValue::make_table();
+			counter(table, "hits", load(stats.hits));
+			counter(table, "misses", load(stats.misses));
+			caches.add(FieldValue::from_string(name), std::move(table));
+		};
+		cache("names", m_name_cache.Stats());
+		cache("texts", m_text_cache.Stats());
+		cache("objects", m_object_cache.Stats());
+		cache("softPaths", m_soft_path_cache.Stats());
+
+		FieldValue snapshot = FieldValue::make_table();
+		snapshot.add(FieldValue::from_string("tables"), std::move(tables));
+		snapshot.add(FieldValue::from_string("fields"), std::move(fields));
+		snapshot.add(FieldValue::from_string("caches"), std::move(caches));
+		FieldValue sweeps = FieldValue::make_table();
+		counter(sweeps, "count", load(m_sweeps.count));
+		counter(sweeps, "totalNs", load(m_sweeps.nanoseconds));
+		counter(sweeps, "maxNs", load(m_sweeps.maxNanoseconds));
+		snapshot.add(FieldValue::from_string("resolveSweeps"), std::move(sweeps));
+		counter(snapshot, "pendingWrites", m_row_writes.Size());
+		counter(snapshot, "parkedWrites", m_parked_count.load(std::memory_order_relaxed));
+		return snapshot;
+	}
+
+	// Writes the stats to the file set with ConfigureWorkbench, if any
+	auto WriteStatsFile() const -> void
+	{
+		std::filesystem::path path;
+		{
+			std::lock_guard lock(m_stats_file_mutex);
+			path = m_stats_file;
+		}
+		if (path.empty() || !TFWWORKBENCH_STATS) return;
+
+		std::string json;
+		WriteJson(CollectStats(), json);
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.write(json.data(), static_cast<std::streamsize>(json.size())))
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Failed to write stats file: {}\n"), path.wstring());
+		}
+	}
+
+	// Starts capturing calls into the call trace at `path` (see CallTrace.hpp), or stops with an
+	// empty path. A capture opens with the tables configured so far, the layouts of those already
+	// resolved and the current settings, so it replays on its own whenever it was started.
+	auto SetCaptureFile(std::string_view path) -> void
+	{
+		m_capturing.store(false, std::memory_order_relaxed);
+		if (path.empty())
+		{
+			m_capture.Close();
+			return;
+		}
+
+		std::string error;
+		std::filesystem::path capturePath(std::u8string(path.begin(), path.end()));
+		if (!m_capture.Open(capturePath, error))
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] Failed to start capture: {}\n"), to_wstring(error));
+			return;
+		}
 
-			int32 structSize = rowStruct->GetPropertiesSize();
-			uint8* newRow = static_cast<uint8*>(FMemory::Malloc(structSize, rowStruct->GetMinAlignment()));
-			if (!newRow)
+		std::vector<DataTableEntry*> entries;
+		{
+			std::shared_lock lock(m_data_tables_mutex);
+			for (const auto& entry : m_data_tables) entries.push_back(entry.get());
+		}
+		for (DataTableEntry* entry : entries) CaptureConfigureTable(entry->name, entry->path);
+		{
+			std::lock_guard lock(m_resolve_mutex);
+			for (DataTableEntry* entry : entries)
 			{
-				Output::send<LogLevel::Error>(STR("[TFWWorkbench] Failed to allocate memory for new row\n"));
-				lua.set_bool(false);
-				return 1;
+				if (entry->resolved.load(std::memory_order_relaxed) && entry->plan) CaptureTableLayout(*entry);
 			}
+		}
+
+		FieldValue options = FieldValue::make_table();
+		options.add(FieldValue::from_string("frameBudgetMs"), FieldValue::from_number(m_frame_budget_us.load(std::memory_order_relaxed) / 1000.0));
+		options.add(FieldValue::from_string("buildThreads"), FieldValue::from_integer(static_cast<int64_t>(m_build_pool.ThreadCount())));
+		options.add(FieldValue::from_string("incrementalWrites"), FieldValue::from_bool(m_incremental_writes.load(std::memory_order_relaxed)));
+		CaptureConfigure(options);
+
+		m_capture_writes.store(false, std::memory_order_relaxed);
+		m_capturing.store(true, std::memory_order_relaxed);
+		Output::send<LogLevel::Default>(STR("[TFWWorkbench] Capturing calls to {}\n"), capturePath.wstring());
+	}
+
+	auto CaptureConfigureTable(std::string_view tableName, StringViewType tablePath) -> void
+	{
+		CallTraceRecord record(CallRecordKind::ConfigureTable);
+		record.AddString(tableName);
+		record.AddString(to_string(tablePath));
+		m_capture.Append(record);
+	}
+
+	auto CaptureConfigure(const FieldValue& options) -> void
+	{
+		CallTraceRecord record(CallRecordKind::Configure);
+		record.AddValue(options);
+		m_capture.Append(record);
+	}
+
+	// Called under m_resolve_mutex once the entry's plan is set
+	auto CaptureTableLayout(const DataTableEntry& entry) -> void
+	{
+		if (!entry.plan) return;
+
+		FieldValue structs = FieldValue::make_table();
+		std::unordered_set<const StructWritePlan*> described;
+		DescribeStruct(*entry.plan, structs, described);
 
-			rowStruct->InitializeStruct(newRow);
+		FieldValue layout = FieldValue::make_table();
+		layout.add(FieldValue::from_string("row"), FieldValue::from_string(to_string(entry.plan->scriptStruct->GetPathName())));
+		layout.add(FieldValue::from_string("structs"), std::move(structs));
+
+		CallTraceRecord record(CallRecordKind::TableLayout);
+		record.AddString(entry.name);
+		record.AddValue(layout);
+		m_capture.Append(record);
+	}
+
+	// Adds `plan` and the structs its fields use to `structs`, in the layout format of CallTrace.hpp
+	static auto DescribeStruct(const StructWritePlan& plan, FieldValue& structs, std::unordered_set<const StructWritePlan*>& described) -> void
+	{
+		if (!described.insert(&plan).second) return;
+
+		FieldValue fields = FieldValue::make_table();
+		int64_t index = 1;
+		for (const PropertyWritePlan* field : plan.fieldOrder)
+		{
+			fields.add(FieldValue::from_integer(index++), DescribeField(*field, structs, described));
+		}
+
+		FieldValue description = FieldValue::make_table();
+		description.add(FieldValue::from_string("size"), FieldValue::from_integer(plan.scriptStruct->GetStructureSize()));
+		description.add(FieldValue::from_string("fields"), std::move(fields));
+		structs.add(FieldValue::from_string(to_string(plan.scriptStruct->GetPathName())), std::move(description));
+	}
+
+	static auto DescribeField(const PropertyWritePlan& plan, FieldValue& structs, std::unordered_set<const StructWritePlan*>& described) -> FieldValue
+	{
+		FieldValue field = FieldValue::make_table();
+		field.add(FieldValue::from_string("name"), FieldValue::from_string(to_string(plan.name)));
+		field.add(FieldValue::from_string("kind"), FieldValue::from_string(PropertyKindName(plan.kind)));
+		field.add(FieldValue::from_string("size"), FieldValue::from_integer(plan.property->GetSize()));
+		if (plan.kind == PropertyKind::Struct && plan.structPlan)
+		{
+			DescribeStruct(*plan.structPlan, structs, described);
+			field.add(FieldValue::from_string("struct"), FieldValue::from_string(to_string(plan.structPlan->scriptStruct->GetPathName())));
+		}
+		if (plan.inner) field.add(FieldValue::from_string("inner"), DescribeField(*plan.inner, structs, described));
+		if (plan.value) field.add(FieldValue::from_string("value"), DescribeField(*plan.value, structs, described));
+		return field;
+	}
+
+	// Appends `writes` to the call trace as one call per run of writes to the same table. Rows of
+	// an import replayed from the row cache are decoded for it. Rows added as images through
+	// the C API are already built when they are queued, and hold no input to capture.
+	auto CaptureRowWrites(std::span<const PendingRowWrite> writes) -> void
+	{
+		static_assert(static_cast<uint8>(RowWriteMode::Clone) == static_cast<uint8>(CallWriteMode::Clone));
+		if (!m_capturing.load(std::memory_order_relaxed)) return;
 
-			FName new_fname(to_wstring(newRowName).c_str(), FNAME_Add);
-			dataTable->AddRow(new_fname, *reinterpret_cast<FTableRowBase*>(newRow));
-			uint8* actualRow = dataTable->FindRowUnchecked(new_fname);
-			if (!actualRow)
+		for (size_t start = 0; start < writes.size();)
+		{
+			const DataTableEntry* entry = writes[start].entry;
+			size_t end = start;
+			size_t count = 0;
+			for (; end < writes.size() && writes[end].entry == entry; end++)
 			{
-				Output::send<LogLevel::Error>(STR("[TFWWorkbench] Failed to find newly added row\n"));
-				lua.set_bool(false);
-				return 1;
+				if (!writes[end].staged) count++;
 			}
 
-			lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference table) -> bool {
-				if (!table.key.is_string()) return false;
-
-				int stackBefore = lua_gettop(lua.get_lua_state());
+			CallTraceRecord record(CallRecordKind::Writes);
+			record.AddString(entry->name);
+			record.AddU32(static_cast<uint32>(count));
+			for (const PendingRowWrite& write : writes.subspan(start, end - start))
+			{
+				if (write.staged) continue;
 
-				auto propertyName = to_wstring(table.key.get_string());
-				Output::send<LogLevel::Verbose>(STR("[TFWWorkbench] Processing field '{}', stack depth: {}\n"),
-					propertyName, stackBefore);
-				//Output::send<LogLevel::Verbose>(STR("[TFWWorkbench] Got property '{}'\n"), propertyName);
-				FProperty* property = rowStruct->GetPropertyByNameInChain(propertyName.c_str());
-				if (!property)
+				record.AddU8(static_cast<uint8>(write.mode));
+				record.AddString(write.rowName);
+				record.AddString(write.sourceRow);
+				if (write.replay)
 				{
-					Output::send<LogLevel::Warning>(
-						STR("[TFWWorkbench] Property '{}' not found, skipping\n"),
-						propertyName
-					);
-					return false;
+					FieldValue fields;
+					if (!ReadCachedFields(write.replay->file.ReadRow(write.cachedRow), false, fields)) fields = FieldValue::make_table();
+					record.AddValue(fields);
 				}
-
-				void* propertyPtr = property->ContainerPtrToValuePtr<void>(actualRow);
-				SetPropertyValueFromLua(lua, table, property, propertyPtr, propertyName);
-
-				int stackAfter = lua_gettop(lua.get_lua_state());
-				if (stackBefore != stackAfter)
+				else
 				{
-					Output::send<LogLevel::Error>(
-						STR("[TFWWorkbench] STACK IMBALANCE after '{}: before={}, after={}\n"),
-						propertyName, stackBefore, stackAfter
-					);
+					record.AddValue(write.fields);
 				}
+			}
+			if (count > 0)
+			{
+				m_capture.Append(record);
+				m_capture_writes.store(true, std::memory_order_relaxed);
+			}
+			start = end;
+		}
+	}
 
-				return false;
-			});
-
-			Output::send<LogLevel::Default>(STR("[TFWWorkbench] Successfully added row '{}'\n"), to_wstring(newRowName));
+	// GetWorkbenchStats()
+	// Returns the counters collected since the mod loaded:
+	//   tables        per configured table: rowsWritten, rowsFailed, rowsUnchanged, rowsPatched,
+	//                 fieldsWritten, unknownFields, rowsBuilt with the totalNs/maxNs spent writing their fields, resolveNs,
+	//                 rowCacheHits, rowCacheMisses
+	//   fields        per property kind written: count, totalNs, maxNs
+	//   caches        names, texts, objects, softPaths: hits, misses
+	//   resolveSweeps passes over the object array looking for DataTables: count, totalNs, maxNs
+	//   pendingWrites row writes still queued
+	//   parkedWrites  row writes waiting for their table to load
+	// Fields of nested structs and container elements are counted as well, and a struct or
+	// container's time includes theirs. Returns false when stats were compiled out.
+	static auto Lua_GetWorkbenchStats(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
+			return 1;
+		}
 
-			// Cleanup
-			rowStruct->DestroyStruct(newRow);
-			FMemory::Free(newRow);
+#if TFWWORKBENCH_STATS
+		FieldValueToLua(lua.get_lua_state(), s_instance->CollectStats());
+#else
+		Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Stats were compiled out of this build\n"));
+		lua.set_bool(false);
+#endif
+		return 1;
+	}
 
-			lua.set_bool(true);
+	// GetDataTableRowChanges(table)
+	// Returns { RowName = "added" | "changed", ... } for the rows written with incrementalWrites
+	// on since the last call, leaving out those whose input had not changed, and clears the list.
+	// A row that was not in the table before its first write counts as added.
+	static auto Lua_GetDataTableRowChanges(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
+		{
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
 			return 1;
 		}
-		catch (const std::exception& e)
+
+		DataTableEntry* entry = GetDataTableArg(lua);
+		if (!entry)
 		{
-			Output::send<LogLevel::Error>(
-				STR("[TFWWorkbench] Exception: {}\n"),
-				to_wstring(e.what())
-			);
 			lua.set_bool(false);
 			return 1;
 		}
+
+		std::unordered_map<std::string, bool, StringHash, std::equal_to<>> changes;
+		{
+			std::lock_guard lock(entry->inputsMutex);
+			changes.swap(entry->changes);
+		}
+
+		FieldValue result = FieldValue::make_table();
+		for (const auto& [rowName, added] : changes)
+		{
+			result.add(FieldValue::from_string(rowName), FieldValue::from_string(added ? "added" : "changed"));
+		}
+		FieldValueToLua(lua.get_lua_state(), result);
+		return 1;
 	}
 
+	// ConfigureDataTables(name, path)
+	// Returns an integer handle that every row API accepts in place of the name.
 	static auto Lua_ConfigureDataTables(const LuaMadeSimple::Lua& lua) -> int
 	{
 		if (!s_instance)
@@ -656,36 +5106,203 @@ private:
 			return 1;
 		}
 
-		Output::send<LogLevel::Verbose>(
+		lua.set_integer(s_instance->ConfigureDataTable(tableName, tablePath));
+		return 1;
+	}
+
+	// Adds table `tableName` to the registry and returns its handle. A table that is already
+	// configured keeps its path and handle.
+	auto ConfigureDataTable(const std::string& tableName, const StringType& tablePath) -> int32
+	{
+		TFW_LOG_VERBOSE(
 			STR("[TFWWorkbench] Configuring DataTable: {} | {}\n"),
 			to_wstring(tableName), tablePath
 		);
+		if (m_capturing.load(std::memory_order_relaxed)) CaptureConfigureTable(tableName, tablePath);
 
-		try
+		std::unique_lock lock(m_data_tables_mutex);
+		if (auto it = m_data_table_handles.find(tableName); it != m_data_table_handles.end())
+		{
+			const DataTableEntry& existing = *m_data_tables[it->second - 1];
+			if (existing.path != tablePath)
+			{
+				Output::send<LogLevel::Warning>(
+					STR("[TFWWorkbench] DataTable {} is already configured as {}, ignoring {}\n"),
+					to_wstring(tableName), existing.path, tablePath
+				);
+			}
+			return existing.handle;
+		}
+
+		auto entry = std::make_unique<DataTableEntry>();
+		entry->handle = static_cast<int32>(m_data_tables.size()) + 1;
+		entry->name = tableName;
+		entry->path = tablePath;
+
+		m_data_table_handles.emplace(tableName, entry->handle);
+		m_data_tables.push_back(std::move(entry));
+		// Resolved along with every other table configured before it is first used
+		m_sweep_pending.store(true, std::memory_order_release);
+		return m_data_tables.back()->handle;
+	}
+
+	// ConfigureWorkbench({ verbose = bool, trace = bool, traceFile = string, frameBudgetMs = number,
+	//                     rowCache = bool, rowCacheDir = string, buildThreads = integer,
+	//                     stats = bool, statsFile = string, incrementalWrites = bool,
+	//                     captureFile = string })
+	// buildThreads sets how many workers build rows off the game thread, 0 builds them all on it.
+	// incrementalWrites keeps a hash of what each row added with AddDataTableRow(s) was written
+	// from. Adding the row again then skips it when nothing changed, and patches only the changed
+	// fields when no field was left out and no struct field changed, so a reloaded script costs
+	// a hash pass over its rows. Off by default, see GetDataTableRowChanges.
+	// stats turns the GetWorkbenchStats counters on or off (on by default), and statsFile names a
+	// JSON file they are written to when the mod unloads.
+	// captureFile starts capturing every configured table, setting and row write into a call
+	// trace (see CallTrace.hpp) that bench/ReplayTrace.cpp replays outside the game. An empty
+	// string stops the capture.
+	// Options that are left out keep their current value.
+	static auto Lua_ConfigureWorkbench(const LuaMadeSimple::Lua& lua) -> int
+	{
+		if (!s_instance)
 		{
-			s_instance->dataTables.insert({ tableName, tablePath });
+			Output::send<LogLevel::Error>(STR("[TFWWorkbench] No instance available\n"));
+			lua.set_bool(false);
+			return 1;
 		}
-		catch (const std::exception& ex)
+
+		if (!lua.is_table())
 		{
 			Output::send<LogLevel::Error>(
-				STR("[TFWWorkbench] Failed to configure data table: {} - {}\n"),
-				to_wstring(tableName), tablePath
-			);
-			Output::send<LogLevel::Error>(
-				STR("[TFWWorkbench] {}\n"), to_wstring(ex.what())
+				STR("[TFWWorkbench] Invalid parameters. Expected: (table)\n")
 			);
 			lua.set_bool(false);
 			return 1;
 		}
 
+		// Settings that change how writes are applied, for the call trace
+		FieldValue captured = FieldValue::make_table();
+		auto capture = [&](std::string_view name, FieldValue value) {
+			captured.add(FieldValue::from_string(name), std::move(value));
+		};
+		std::string captureFile;
+		bool setCaptureFile = false;
+
+		lua.for_each_in_table([&](LuaMadeSimple::LuaTableReference option) -> bool {
+			if (!option.key.is_string()) return false;
+
+			std::string_view name = option.key.get_string();
+			if (name == "verbose" && option.value.is_bool())
+			{
+				s_verbose_logging = option.value.get_bool();
+			}
+			else if (name == "trace" && option.value.is_bool())
+			{
+				s_tracing = option.value.get_bool();
+			}
+			else if (name == "traceFile" && option.value.is_string())
+			{
+				s_instance->m_trace.SetFilePath(option.value.get_string());
+			}
+			else if (name == "frameBudgetMs" && option.value.is_number())
+			{
+				s_instance->m_frame_budget_us = static_cast<int64>(std::max(0.0, option.value.get_number()) * 1000.0);
+				capture(name, FieldValue::from_number(option.value.get_number()));
+			}
+			else if (name == "rowCache" && option.value.is_bool())
+			{
+				std::lock_guard lock(s_instance->m_row_cache_mutex);
+				s_instance->m_row_cache_enabled = option.value.get_bool();
+			}
+			else if (name == "buildThreads" && option.value.is_number())
+			{
+				s_instance->m_build_pool.SetThreadCount(static_cast<size_t>(std::clamp(option.value.get_number(), 0.0, 64.0)));
+				capture(name, FieldValue::from_number(option.value.get_number()));
+			}
+			else if (name == "incrementalWrites" && option.value.is_bool())
+			{
+				s_instance->m_incremental_writes = option.value.get_bool();
+				capture(name, FieldValue::from_bool(option.value.get_bool()));
+			}
+			else if (name == "stats" && option.value.is_bool())
+			{
+				WorkbenchStats::s_enabled = option.value.get_bool();
+			}
+			else if (name == "statsFile" && option.value.is_string())
+			{
+				std::string_view statsFile = option.value.get_string();
+				std::lock_guard lock(s_instance->m_stats_file_mutex);
+				s_instance->m_stats_file = std::filesystem::path(std::u8string(statsFile.begin(), statsFile.end()));
+			}
+			else if (name == "rowCacheDir" && option.value.is_string())
+			{
+				std::string_view rowCacheDir = option.value.get_string();
+				std::lock_guard lock(s_instance->m_row_cache_mutex);
+				s_instance->m_row_cache_dir = std::filesystem::path(std::u8string(rowCacheDir.begin(), rowCacheDir.end()));
+			}
+			else if (name == "captureFile" && option.value.is_string())
+			{
+				captureFile = option.value.get_string();
+				setCaptureFile = true;
+			}
+			else
+			{
+				Output::send<LogLevel::Warning>(
+					STR("[TFWWorkbench] Ignoring unknown or mistyped option '{}'\n"),
+					to_wstring(name)
+				);
+			}
+			return false;
+		});
+
+		// A capture started here records the settings as they are now
+		if (setCaptureFile)
+		{
+			s_instance->SetCaptureFile(captureFile);
+		}
+		else if (!captured.get_table().empty() && s_instance->m_capturing.load(std::memory_order_relaxed))
+		{
+			s_instance->CaptureConfigure(captured);
+		}
+
+#if !TFWWORKBENCH_VERBOSE_LOGGING
+		if (s_verbose_logging)
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Verbose logging was compiled out of this build\n"));
+		}
+#endif
+#if !TFWWORKBENCH_TRACING
+		if (s_tracing)
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Tracing was compiled out of this build\n"));
+		}
+#endif
+#if !TFWWORKBENCH_STATS
+		if (WorkbenchStats::s_enabled)
+		{
+			Output::send<LogLevel::Warning>(STR("[TFWWorkbench] Stats were compiled out of this build\n"));
+		}
+#endif
+
 		lua.set_bool(true);
 		return 1;
 	}
 };
 
 TFWWorkbench* TFWWorkbench::s_instance = nullptr;
+thread_local TFWWorkbench::TraceContext TFWWorkbench::t_trace_context = {};
+std::atomic<uint64> TraceRing::s_next_id = 1;
+thread_local TraceRing::ThreadState TraceRing::t_state = {};
+std::atomic<bool> TFWWorkbench::s_verbose_logging = false;
+std::atomic<bool> TFWWorkbench::s_tracing = false;
+std::atomic<bool> WorkbenchStats::s_enabled = TFWWORKBENCH_STATS != 0;
+std::atomic<uint64> WorkbenchStats::s_next_id = 1;
+thread_local WorkbenchStats::ThreadState WorkbenchStats::t_state = {};
 
+#ifdef _WIN32
 #define TFWWORKBENCH_MOD_API __declspec(dllexport)
+#else
+#define TFWWORKBENCH_MOD_API __attribute__((visibility("default")))
+#endif
 extern "C"
 {
 	TFWWORKBENCH_MOD_API RC::CppUserModBase* start_mod()
@@ -697,4 +5314,34 @@ extern "C"
 	{
 		delete mod;
 	}
+
+	TFWWORKBENCH_API int32_t TFWWorkbench_GetApiVersion(void)
+	{
+		return TFWWORKBENCH_API_VERSION;
+	}
+
+	TFWWORKBENCH_API int32_t TFWWorkbench_ConfigureTable(const char* name, const char* path)
+	{
+		return TFWWorkbench::Api_ConfigureTable(name, path);
+	}
+
+	TFWWORKBENCH_API int32_t TFWWorkbench_FindTable(const char* name)
+	{
+		return TFWWorkbench::Api_FindTable(name);
+	}
+
+	TFWWORKBENCH_API int32_t TFWWorkbench_WriteRows(int32_t table, const TFWRow* rows, size_t count, int32_t mode)
+	{
+		return TFWWorkbench::Api_WriteRows(table, rows, count, mode);
+	}
+
+	TFWWORKBENCH_API int32_t TFWWorkbench_AddRowImages(int32_t table,
+		const void* rowStruct,
+		const char* const* rowNames,
+		const void* images,
+		size_t imageSize,
+		size_t count)
+	{
+		return TFWWorkbench::Api_AddRowImages(table, rowStruct, rowNames, images, imageSize, count);
+	}
 }
\ No newline at end of file